@@ -0,0 +1,158 @@
+#include "decoding/abi_parser.h"
+#include "decoding/abi_snapshot.h"
+#include "utils.h"
+#include "src/build_abi_snapshot_arg_parser.h"
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+namespace build_abi_snapshot {
+
+namespace {
+
+// Add one contract, reporting instead of aborting on malformed entries
+bool addContract(ethereum_decoder::ABISnapshotWriter &writer, const std::string &address,
+                 const std::string &name, const std::string &abiJson) {
+    try {
+        ethereum_decoder::ABIParser abiParser;
+        auto abi = abiParser.parseFromString(abiJson);
+        writer.add(address, name, *abi);
+        return true;
+    } catch (const std::exception &e) {
+        std::cerr << "Skipping " << address << ": " << e.what() << std::endl;
+        return false;
+    }
+}
+
+// Files of an ABI directory are named after their contract: <address>.json
+bool isAddress(const std::string &value) {
+    return value.size() == 42 && value.compare(0, 2, "0x") == 0 && ethereum_decoder::Utils::isValidHex(value);
+}
+
+size_t addAbiDir(ethereum_decoder::ABISnapshotWriter &writer, const std::string &dir) {
+    size_t added = 0;
+    for (const auto &entry: std::filesystem::directory_iterator(dir)) {
+        if (!entry.is_regular_file() || entry.path().extension() != ".json") {
+            continue;
+        }
+
+        std::string address = entry.path().stem().string();
+        if (!isAddress(address)) {
+            std::cerr << "Warning: skipping " << entry.path().string()
+                      << ": file name is not a contract address (expected <0x address>.json)" << std::endl;
+            continue;
+        }
+
+        std::ifstream file(entry.path());
+        std::string abiJson((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        if (addContract(writer, address, "", abiJson)) {
+            added++;
+        }
+    }
+    return added;
+}
+
+size_t addExport(ethereum_decoder::ABISnapshotWriter &writer, const std::string &path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Failed to open export file: " + path);
+    }
+
+    size_t added = 0;
+    size_t lineNumber = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty()) {
+            continue;
+        }
+
+        std::string address;
+        std::string name;
+        std::string abiJson;
+        std::string implementationAddress;
+        try {
+            auto row = nlohmann::json::parse(line);
+            address = row.value("ADDRESS", "");
+            name = row.value("NAME", "");
+            abiJson = row.value("ABI", "");
+            implementationAddress = row.value("IMPLEMENTATION_ADDRESS", "");
+        } catch (const nlohmann::json::exception &e) {
+            std::cerr << "Skipping " << path << " line " << lineNumber << ": " << e.what() << std::endl;
+            continue;
+        }
+        if (abiJson.empty()) {
+            continue;
+        }
+
+        // Mirror getBatchContractABI: a proxy's implementation resolves to the same ABI
+        if (addContract(writer, address, name, abiJson)) {
+            added++;
+        }
+        if (!implementationAddress.empty() && addContract(writer, implementationAddress, name, abiJson)) {
+            added++;
+        }
+    }
+    return added;
+}
+
+} // anonymous namespace
+
+int run(int argc, char *argv[]) {
+    try {
+        BuildAbiSnapshotArgParser argParser;
+        ParsedArgs args;
+
+        try {
+            args = argParser.parse(argc, argv);
+        } catch (const std::exception &e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            argParser.printUsage(argv[0]);
+            return 1;
+        }
+
+        if (args.showHelp) {
+            argParser.printUsage(argv[0]);
+            return 0;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        ethereum_decoder::ABISnapshotWriter writer;
+
+        for (const auto &dir: args.abiDirs) {
+            size_t added = addAbiDir(writer, dir);
+            std::cout << "Added " << added << " contracts from " << dir << std::endl;
+        }
+        for (const auto &path: args.exportFiles) {
+            size_t added = addExport(writer, path);
+            std::cout << "Added " << added << " contracts from " << path << std::endl;
+        }
+
+        // Entries from the inputs take precedence over the base snapshot
+        if (!args.basePath.empty()) {
+            auto base = ethereum_decoder::ABISnapshot::open(args.basePath);
+            writer.addAll(*base);
+            std::cout << "Merged " << base->size() << " contracts from " << args.basePath << std::endl;
+        }
+
+        writer.write(args.outputPath);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "Wrote " << writer.size() << " contracts to " << args.outputPath
+                  << " in " << elapsed << " ms" << std::endl;
+    } catch (const std::exception &e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+} // namespace build_abi_snapshot
+
+int main(int argc, char *argv[]) {
+    return build_abi_snapshot::run(argc, argv);
+}
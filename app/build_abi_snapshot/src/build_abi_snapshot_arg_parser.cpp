@@ -0,0 +1,64 @@
+#include "build_abi_snapshot_arg_parser.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace build_abi_snapshot {
+
+ParsedArgs BuildAbiSnapshotArgParser::parse(int argc, char* argv[]) {
+    ParsedArgs args;
+
+    if (argc < 2) {
+        throw std::runtime_error("Insufficient arguments. Use --help for usage information.");
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            args.showHelp = true;
+            return args;
+        }
+    }
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--output" && i + 1 < argc) {
+            args.outputPath = argv[++i];
+        } else if (arg == "--base" && i + 1 < argc) {
+            args.basePath = argv[++i];
+        } else if (arg == "--abi-dir" && i + 1 < argc) {
+            args.abiDirs.push_back(argv[++i]);
+        } else if (arg == "--export" && i + 1 < argc) {
+            args.exportFiles.push_back(argv[++i]);
+        } else {
+            throw std::runtime_error("Unknown argument: " + arg);
+        }
+    }
+
+    if (args.outputPath.empty()) {
+        throw std::runtime_error("--output is required");
+    }
+    if (args.basePath.empty() && args.abiDirs.empty() && args.exportFiles.empty()) {
+        throw std::runtime_error("No input specified. Use --abi-dir, --export or --base.");
+    }
+
+    return args;
+}
+
+void BuildAbiSnapshotArgParser::printUsage(const char* programName) const {
+    std::cout << "Usage: " << programName << " --output <snapshot> [inputs]" << std::endl;
+    std::cout << "\nInputs (may be repeated):" << std::endl;
+    std::cout << "  --abi-dir <dir>     Directory of ABI files named <address>.json" << std::endl;
+    std::cout << "  --export <file>     ClickHouse export of decoded_contracts in JSONEachRow format" << std::endl;
+    std::cout << "                      (columns ADDRESS, NAME, ABI, IMPLEMENTATION_ADDRESS)" << std::endl;
+    std::cout << "  --base <snapshot>   Existing snapshot to extend; newer inputs replace its entries" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --output <path>     Snapshot file to write" << std::endl;
+    std::cout << "  --help, -h          Show this help message" << std::endl;
+    std::cout << "\nExample:" << std::endl;
+    std::cout << "  clickhouse-client --query \"SELECT ADDRESS, NAME, ABI, IMPLEMENTATION_ADDRESS"
+              << " FROM decoded_contracts WHERE ABI != '' FORMAT JSONEachRow\" > contracts.jsonl" << std::endl;
+    std::cout << "  " << programName << " --export contracts.jsonl --output abis.snapshot" << std::endl;
+}
+
+} // namespace build_abi_snapshot
@@ -0,0 +1,31 @@
+#ifndef BUILD_ABI_SNAPSHOT_ARG_PARSER_H
+#define BUILD_ABI_SNAPSHOT_ARG_PARSER_H
+
+#include <string>
+#include <vector>
+
+namespace build_abi_snapshot {
+
+struct ParsedArgs {
+    std::string outputPath;
+    std::string basePath;                  // Existing snapshot to extend, optional
+    std::vector<std::string> abiDirs;      // Directories of <address>.json files
+    std::vector<std::string> exportFiles;  // ClickHouse JSONEachRow exports of decoded_contracts
+    bool showHelp = false;
+};
+
+class BuildAbiSnapshotArgParser {
+public:
+    BuildAbiSnapshotArgParser() = default;
+    ~BuildAbiSnapshotArgParser() = default;
+
+    // Parse command line arguments
+    ParsedArgs parse(int argc, char* argv[]);
+
+    // Print usage information
+    void printUsage(const char* programName) const;
+};
+
+} // namespace build_abi_snapshot
+
+#endif // BUILD_ABI_SNAPSHOT_ARG_PARSER_H
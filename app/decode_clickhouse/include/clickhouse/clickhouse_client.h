@@ -16,17 +16,8 @@
 
 namespace decode_clickhouse {
 
-struct LogRecord {
-    std::string transactionHash;
-    uint64_t blockNumber;
-    std::string address;
-    std::string data;
-    uint64_t logIndex;
-    std::string topic0;
-    std::string topic1;
-    std::string topic2;
-    std::string topic3;
-};
+// Compression method for a config value (none, lz4 or zstd), throws on anything else
+clickhouse::CompressionMethod parseCompressionMethod(const std::string& name);
 
 struct ContractABI {
     std::string address;
@@ -43,6 +34,9 @@ public:
     
     std::shared_ptr<clickhouse::Client> getConnection();
     void returnConnection(std::shared_ptr<clickhouse::Client> client);
+
+    // Open a connection that is not part of the pool, e.g. one kept for inserts
+    std::shared_ptr<clickhouse::Client> createConnection(const std::string& compression);
     
 private:
     ClickHouseConfig config_;
@@ -50,8 +44,6 @@ private:
     std::mutex mutex_;
     std::condition_variable condition_;
     size_t poolSize_;
-    
-    std::shared_ptr<clickhouse::Client> createConnection();
 };
 
 class ClickHouseClient {
@@ -68,6 +60,8 @@ public:
     
     // Get access to the connection pool (for ClickHouseEthereum class)
     ClickHouseConnectionPool* getPool() const;
+
+    const ClickHouseConfig& getConfig() const { return config_; }
     
 private:
     ClickHouseConfig config_;
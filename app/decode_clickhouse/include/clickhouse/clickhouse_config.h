@@ -11,6 +11,14 @@ struct ClickHouseConfig {
     std::string password;
     std::string database;
     int port = 9440;
+
+    // Wire compression of the native protocol: none, lz4 or zstd
+    std::string compression = "lz4";
+    std::string insertCompression = "";  // Empty uses compression
+
+    const std::string& getInsertCompression() const {
+        return insertCompression.empty() ? compression : insertCompression;
+    }
 };
 
 } // namespace decode_clickhouse
@@ -3,37 +3,80 @@
 
 #include "clickhouse_client.h"
 #include "clickhouse_query_config.h"
+#include "log_page.h"
 #include "../../../ethereum_decoder/include/types.h"
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <functional>
 
 namespace decode_clickhouse {
 
+// How streamLogs spreads the block range over pooled connections
+struct StreamOptions {
+    size_t shards = 1;            // Concurrent fetch connections; 1 fetches pages serially
+    uint64_t shardBlocks = 1000;  // Blocks per shard, shards are handed to fetchers in block order
+    bool ordered = true;          // Deliver pages in (blockNumber, logIndex) order; false delivers as fetched
+    bool binary = false;          // Fetch data and topics as raw bytes with the binary log stream query
+    uint64_t startLogIndex = 0;   // First log index read in the start block, to continue a partly read block
+};
+
 class ClickHouseEthereum {
 public:
     explicit ClickHouseEthereum(ClickHouseClient& client);
     explicit ClickHouseEthereum(ClickHouseClient& client, const std::string& sqlConfigDir);
     ~ClickHouseEthereum() = default;
+
+    ClickHouseEthereum(const ClickHouseEthereum&) = delete;
+    ClickHouseEthereum& operator=(const ClickHouseEthereum&) = delete;
     
-    // Stream logs and process them page by page with callback
-    void streamLogs(uint64_t startBlock, uint64_t endBlock, 
-                   std::function<void(std::vector<LogRecord>&, size_t pageNumber, size_t totalProcessed)> callback);
+    using PageCallback = std::function<void(LogPage&, size_t pageNumber, size_t totalProcessed)>;
+
+    // Stream logs and process them page by page with callback. The callback always runs on
+    // the calling thread; with several shards the next pages are fetched while it runs.
+    // A failed query is rethrown once the fetchers stopped, the range is then incomplete
+    void streamLogs(uint64_t startBlock, uint64_t endBlock, PageCallback callback,
+                    const StreamOptions& options = StreamOptions());
     
     // Batch get ABIs for multiple contract addresses (includes proxy support)
-    std::map<std::string, ContractABI> getBatchContractABI(const std::vector<std::string>& addresses);
+    // If given, fetched is set to false when the query failed and the result is incomplete
+    std::map<std::string, ContractABI> getBatchContractABI(const std::vector<std::string>& addresses,
+                                                           bool* fetched = nullptr);
     
-    // Insert decoded logs with optimized batch processing
+    // Insert decoded logs as one native block, a single round-trip per batch
     bool insertDecodedLogs(const std::vector<ethereum_decoder::DecodedLogRecord>& decodedLogs);
+
+    // Have inserts return only once the server has flushed their async insert buffer to the
+    // table, overriding the configured settings. Needed when inserted rows are checkpointed
+    void setWaitForAsyncInsert(bool wait) { waitForAsyncInsert_ = wait; }
     
     // Access to query configuration for customization
     ClickHouseQueryConfig& getQueryConfig() { return queryConfig_; }
     const ClickHouseQueryConfig& getQueryConfig() const { return queryConfig_; }
     
 private:
+    // Fetch one page starting at the keyset cursor, returns the number of rows read
+    size_t fetchLogPage(clickhouse::Client& client, uint64_t startBlock, uint64_t endBlock,
+                        uint64_t cursorBlock, uint64_t cursorLogIndex, bool binary, LogPage& pageResults);
+
+    void streamLogsSharded(uint64_t startBlock, uint64_t endBlock, PageCallback& callback,
+                           const StreamOptions& options);
+
+    static void logStreamError(const std::exception& e);
+
+    // Columns of the configured insert, filled from the records
+    clickhouse::Block buildDecodedLogsBlock(const std::vector<ethereum_decoder::DecodedLogRecord>& decodedLogs) const;
+
     ClickHouseClient& client_;
     ClickHouseQueryConfig queryConfig_;
+
+    // Own connection for inserts, outside the pool: it has its own compression and
+    // the insert settings are only sent once
+    std::mutex insertMutex_;
+    std::shared_ptr<clickhouse::Client> insertConnection_;
+    bool waitForAsyncInsert_ = false;
 };
 
 } // namespace decode_clickhouse
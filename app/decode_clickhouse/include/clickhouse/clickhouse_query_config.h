@@ -5,15 +5,16 @@
 #include <vector>
 #include <map>
 
-// Forward declaration
-namespace ethereum_decoder {
-    struct DecodedLogRecord;
-}
-
 namespace decode_clickhouse {
 
 class ClickHouseQueryConfig {
 public:
+    // A column of the decoded logs insert and the DecodedLogRecord field it is filled from
+    struct InsertColumn {
+        std::string name;
+        std::string field;
+    };
+
     ClickHouseQueryConfig();
     ~ClickHouseQueryConfig() = default;
 
@@ -23,11 +24,13 @@ public:
 
     // Query getters
     std::string getLogStreamQuery() const { return logStreamQuery_; }
+    std::string getLogStreamBinaryQuery() const { return logStreamBinaryQuery_; }
     std::string getContractABIQuery() const { return contractABIQuery_; }
     std::string getDecodedLogsInsertQuery() const { return decodedLogsInsertQuery_; }
     
-    // Deprecated - kept for backward compatibility
-    std::string getDecodedLogsInsertTable() const { return "decoded_logs"; }
+    // Target table and columns of the native decoded logs insert, taken from the insert template
+    const std::string& getDecodedLogsInsertTable() const { return decodedLogsInsertTable_; }
+    const std::vector<InsertColumn>& getDecodedLogsInsertColumns() const { return decodedLogsInsertColumns_; }
     
     // ClickHouse settings
     const std::vector<std::string>& getAsyncInsertSettings() const { return asyncInsertSettings_; }
@@ -36,16 +39,21 @@ public:
     size_t getPageSize() const { return pageSize_; }
     void setPageSize(size_t size) { pageSize_ = size; }
 
-    // Format queries with parameters
-    std::string formatLogStreamQuery(uint64_t startBlock, uint64_t endBlock, size_t pageSize, size_t offset) const;
+    // Format queries with parameters. The log stream is paged by keyset: each page starts at
+    // (cursorBlock, cursorLogIndex) inclusive, i.e. right after the last row of the previous page.
+    // binary selects the variant returning data and topics as raw bytes
+    std::string formatLogStreamQuery(uint64_t startBlock, uint64_t endBlock, size_t pageSize,
+                                     uint64_t cursorBlock, uint64_t cursorLogIndex, bool binary = false) const;
     std::string formatContractABIQuery(const std::string& addressList) const;
-    std::string formatDecodedLogsInsertQuery(const ethereum_decoder::DecodedLogRecord& log) const;
 
 private:
     // SQL Query templates
     std::string logStreamQuery_;
+    std::string logStreamBinaryQuery_;
     std::string contractABIQuery_;
     std::string decodedLogsInsertQuery_;
+    std::string decodedLogsInsertTable_;
+    std::vector<InsertColumn> decodedLogsInsertColumns_;
 
     // ClickHouse settings
     std::vector<std::string> asyncInsertSettings_;
@@ -56,6 +64,7 @@ private:
     // Helper methods
     void initializeDefaultQueries();
     void initializeDefaultSettings();
+    void parseDecodedLogsInsertQuery();
     std::string loadFileContent(const std::string& filepath) const;
 };
 
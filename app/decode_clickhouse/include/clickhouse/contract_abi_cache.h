@@ -0,0 +1,64 @@
+#ifndef ETHEREUM_DECODER_CONTRACT_ABI_CACHE_H
+#define ETHEREUM_DECODER_CONTRACT_ABI_CACHE_H
+
+#include "clickhouse_ethereum.h"
+#include "../../../ethereum_decoder/include/ethereum_decoder.h"
+#include "../../../ethereum_decoder/include/decoding/abi_snapshot.h"
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace decode_clickhouse {
+
+// LRU cache of parsed contract ABIs shared across pages and workers.
+// Each entry holds a ready decoder, or nullptr for contracts known to have no usable ABI.
+// With a snapshot path, uncached contracts are looked up in the on-disk ABI snapshot before
+// ClickHouse, and ABIs fetched from ClickHouse can be merged back into it.
+class ContractABICache {
+public:
+    using DecoderPtr = std::shared_ptr<ethereum_decoder::EthereumDecoder>;
+
+    explicit ContractABICache(size_t capacity, const std::string& snapshotPath = "");
+
+    // Decoders for the given addresses that have an ABI. Only addresses not cached yet
+    // are loaded and parsed; parsed ABIs are added to the global signature registry
+    std::map<std::string, DecoderPtr> resolve(const std::vector<std::string>& addresses, ClickHouseEthereum& ethereum);
+
+    // Merge ABIs fetched from ClickHouse during this run into the snapshot file.
+    // Returns the number of contracts added; does nothing without a snapshot path
+    size_t saveSnapshot();
+
+    size_t size() const;
+    size_t getHits() const;
+    size_t getMisses() const;
+
+private:
+    struct Entry {
+        std::string address;
+        DecoderPtr decoder;
+    };
+
+    // Caller must hold mutex_
+    void insert(const std::string& address, DecoderPtr decoder);
+
+    static DecoderPtr createDecoder(std::unique_ptr<ethereum_decoder::ABI> abi);
+    static DecoderPtr parseABI(const std::string& address, const std::string& abiJson);
+
+    size_t capacity_;
+    std::string snapshotPath_;
+    std::unique_ptr<ethereum_decoder::ABISnapshot> snapshot_;
+    std::vector<ContractABI> fetchedABIs_;  // Fetched from ClickHouse, not in the snapshot yet
+    mutable std::mutex mutex_;
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t hits_ = 0;
+    size_t misses_ = 0;
+};
+
+} // namespace decode_clickhouse
+
+#endif // ETHEREUM_DECODER_CONTRACT_ABI_CACHE_H
@@ -0,0 +1,52 @@
+#ifndef ETHEREUM_DECODER_LOG_PAGE_H
+#define ETHEREUM_DECODER_LOG_PAGE_H
+
+#include <clickhouse/client.h>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace decode_clickhouse {
+
+// One fetched log. The strings point into the columns of the LogPage it belongs to
+// and stay valid as long as that page does
+struct LogRecord {
+    std::string_view transactionHash;
+    uint64_t blockNumber = 0;
+    std::string_view address;
+    std::string_view data;
+    uint64_t logIndex = 0;
+    std::string_view topic0;
+    std::string_view topic1;
+    std::string_view topic2;
+    std::string_view topic3;
+    bool binary = false;  // data and topics hold raw bytes instead of hex, see StreamOptions::binary
+};
+
+// A page of logs as returned by the log stream query. Keeps the received blocks alive and
+// indexes their rows without copying: column types are resolved once per block, not per row
+class LogPage {
+public:
+    // Add the rows of a block; its columns must be in log stream query order
+    void append(const clickhouse::Block& block, bool binary);
+
+    // Make room for the logs of a full page before its blocks arrive
+    void reserve(size_t logs) { logs_.reserve(logs); }
+
+    size_t size() const { return logs_.size(); }
+    bool empty() const { return logs_.empty(); }
+
+    const LogRecord& operator[](size_t index) const { return logs_[index]; }
+    const LogRecord& back() const { return logs_.back(); }
+
+    std::vector<LogRecord>::const_iterator begin() const { return logs_.begin(); }
+    std::vector<LogRecord>::const_iterator end() const { return logs_.end(); }
+
+private:
+    std::vector<clickhouse::Block> blocks_;
+    std::vector<LogRecord> logs_;
+};
+
+} // namespace decode_clickhouse
+
+#endif // ETHEREUM_DECODER_LOG_PAGE_H
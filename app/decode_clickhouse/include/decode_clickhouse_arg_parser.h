@@ -2,6 +2,8 @@
 #define DECODE_CLICKHOUSE_ARG_PARSER_H
 
 #include "clickhouse/clickhouse_config.h"
+#include "ndjson/ndjson_writer_options.h"
+#include "parquet/parquet_writer_options.h"
 #include <string>
 
 namespace decode_clickhouse {
@@ -24,9 +26,20 @@ struct ClickHouseArgs {
     std::string logFile = "decode_clickhouse.log";  // Default log file path
     std::string sqlConfigDir = "";  // Optional SQL config directory - empty means use defaults
     std::string outputDir = "decoded_logs";  // Default output directory for parquet/json files
-    bool useJsonOutput = false;  // Default is parquet (if available), use --json to force JSON output
+    bool useJsonOutput = false;  // Default is parquet (if available), use --json to force NDJSON output
     std::string logLevel = "info";  // Default log level: debug, info, warning, error
     size_t logsPageSize = 25000;  // Default page size for fetching logs
+    size_t abiCacheSize = 10000;  // Parsed contract ABIs kept in memory across pages
+    std::string abiSnapshotPath = "";  // Optional on-disk ABI snapshot, refreshed with newly fetched ABIs
+    size_t fetchShards = 4;  // Block range shards fetched concurrently over pooled connections
+    uint64_t shardBlocks = 1000;  // Blocks per fetch shard
+    bool unorderedFetch = false;  // Decode pages as they arrive instead of in block order
+    bool binaryLogs = false;  // Fetch log data and topics as raw bytes instead of hex
+    size_t writeBatchesInFlight = 2;  // Full batches queued per writer for its flush thread, 0 = synchronous writes
+    std::string checkpointFile = "";  // Checkpoint of written positions - empty means <outputDir>/.checkpoint.json
+    bool resume = false;  // Continue after the positions in the checkpoint file
+    ParquetWriterOptions parquet;  // Rolling Parquet file and row group sizes
+    NdjsonWriterOptions json;  // Rolling NDJSON file size and compression
 };
 
 class DecodeClickhouseArgParser {
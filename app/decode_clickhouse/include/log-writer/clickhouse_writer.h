@@ -14,7 +14,9 @@ class ClickhouseWriter : public DatabaseWriter {
 public:
     explicit ClickhouseWriter(std::shared_ptr<ClickHouseEthereum> ethereum, 
                              size_t batchSize = DEFAULT_BATCH_SIZE);
-    ~ClickhouseWriter() override = default;
+    ~ClickhouseWriter() override { shutdown(); }
+
+    std::string getName() const override { return "clickhouse"; }
 
 protected:
     bool writeBatch(const std::vector<ethereum_decoder::DecodedLogRecord>& records) override;
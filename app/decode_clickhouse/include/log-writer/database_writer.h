@@ -1,11 +1,32 @@
 #pragma once
 
 #include "../../ethereum_decoder/include/types.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 namespace decode_clickhouse {
 
+/**
+ * A log's place in the stream, logs are fetched in this order
+ */
+struct LogPosition {
+    uint64_t blockNumber = 0;
+    uint64_t logIndex = 0;
+
+    bool operator<(const LogPosition& other) const {
+        return blockNumber < other.blockNumber ||
+               (blockNumber == other.blockNumber && logIndex < other.logIndex);
+    }
+    bool operator<=(const LogPosition& other) const { return !(other < *this); }
+};
+
 /**
  * Abstract base class for writing decoded logs to different storage backends
  * Implements batching with configurable batch size and automatic flushing
@@ -13,6 +34,8 @@ namespace decode_clickhouse {
 class DatabaseWriter {
 public:
     static constexpr size_t DEFAULT_BATCH_SIZE = 1000;
+
+    using WrittenCallback = std::function<void(const std::vector<LogPosition>&)>;
     
     explicit DatabaseWriter(size_t batchSize = DEFAULT_BATCH_SIZE);
     virtual ~DatabaseWriter();
@@ -23,12 +46,56 @@ public:
      */
     virtual void write(const ethereum_decoder::DecodedLogRecord& record);
 
+    /**
+     * Write a batch of decoded log records
+     * Full batches are flushed as they fill up, the remainder stays pending
+     */
+    virtual void write(const std::vector<ethereum_decoder::DecodedLogRecord>& records);
+
     /**
      * Flush all pending writes immediately
      * Should be called before application exit
+     * In async mode this waits until every queued batch has been written
      */
     virtual void flush();
 
+    /**
+     * Flush and finish the output, e.g. close open files
+     * Called once after the last write
+     */
+    virtual void close() { flush(); }
+
+    /**
+     * Write full batches on a dedicated flush thread instead of the caller's thread
+     * Up to maxInFlightBatches full batches may wait for the flush thread before write() blocks;
+     * 0 keeps flushing synchronous
+     */
+    void enableAsyncFlush(size_t maxInFlightBatches);
+
+    bool isAsync() const { return maxInFlightBatches_ > 0; }
+
+    /**
+     * Called with the positions of written records once they are stored, on the thread that wrote them
+     * Must be set before the first write
+     */
+    void setWrittenCallback(WrittenCallback callback) { writtenCallback_ = std::move(callback); }
+
+    /**
+     * Name that identifies this writer's output, e.g. in the checkpoint file
+     */
+    virtual std::string getName() const = 0;
+
+    /**
+     * Remove output an earlier run left unfinished, e.g. files it never closed. Called before a
+     * resumed run, which writes their records again
+     */
+    virtual void removeIncompleteOutput() {}
+
+    /**
+     * Writers that store typed parameters return true, records then carry DecodedLogRecord::params
+     */
+    virtual bool needsDecodedParams() const { return false; }
+
     /**
      * Get the current number of pending records in the batch
      */
@@ -39,6 +106,17 @@ public:
      */
     size_t getTotalWritten() const { return totalWritten_; }
 
+    /**
+     * Get the total number of records that failed to be written
+     */
+    size_t getTotalFailed() const { return totalFailed_; }
+
+    /**
+     * True once the writer stopped after an error its output cannot recover from.
+     * The run should stop then, so it can be resumed from the checkpoint
+     */
+    bool hasFailed() const { return failed_; }
+
 protected:
     /**
      * Write a batch of records to the storage backend
@@ -58,13 +136,61 @@ protected:
      */
     virtual void onBatchFailed(size_t recordCount, const std::string& error);
 
+    /**
+     * Writers whose output is only complete later, e.g. once a file is closed, return true
+     * and call reportWritten() themselves when it is; otherwise every written batch is reported
+     */
+    virtual bool defersWrittenReport() const { return false; }
+
+    bool hasWrittenCallback() const { return static_cast<bool>(writtenCallback_); }
+
+    /**
+     * Pass positions of stored records to the written callback, if one is set
+     */
+    void reportWritten(const std::vector<LogPosition>& positions);
+
+    /**
+     * Stop writing after an error the output cannot recover from, e.g. a broken open file.
+     * lostRecords of earlier batches, already counted as written, are counted as failed instead.
+     * Called from writeBatch(), which then returns false, storedRecords of the batch still reach
+     * the output and the rest of it fails. Later batches fail without being written
+     */
+    void fail(const std::string& error, size_t lostRecords, size_t storedRecords = 0);
+
+    /**
+     * Flush and stop the flush thread
+     * Derived classes call this from their destructor, while writeBatch() can still run
+     */
+    void shutdown();
+
     size_t batchSize_;
     std::vector<ethereum_decoder::DecodedLogRecord> pendingRecords_;
-    size_t totalWritten_;
-    size_t totalFailed_;
+    std::atomic<size_t> totalWritten_;
+    std::atomic<size_t> totalFailed_;
     
 private:
     void flushIfNeeded();
+
+    // Write one batch and account for the outcome
+    void writeRecords(const std::vector<ethereum_decoder::DecodedLogRecord>& records);
+
+    // Queue pendingRecords_ for the flush thread and continue in a recycled buffer
+    void enqueuePending();
+    void flushLoop();
+
+    WrittenCallback writtenCallback_;
+
+    std::atomic<bool> failed_{false};
+    size_t failedBatchStored_ = 0;  // Set by fail() during writeBatch()
+
+    size_t maxInFlightBatches_ = 0;
+    std::thread flushThread_;
+    std::mutex flushMutex_;
+    std::condition_variable flushCondition_;
+    std::deque<std::vector<ethereum_decoder::DecodedLogRecord>> inFlight_;
+    std::vector<std::vector<ethereum_decoder::DecodedLogRecord>> spareBuffers_;
+    bool writing_ = false;
+    bool stopping_ = false;
 };
 
 } // namespace decode_clickhouse
\ No newline at end of file
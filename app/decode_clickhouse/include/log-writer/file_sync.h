@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+
+namespace decode_clickhouse {
+
+/**
+ * Flush a file's data to disk, throws std::runtime_error if that fails
+ */
+void syncFile(const std::string& path);
+
+/**
+ * Flush a directory's entries to disk, so files created or renamed in it survive a power loss.
+ * Throws std::runtime_error if that fails
+ */
+void syncDirectory(const std::string& path);
+
+} // namespace decode_clickhouse
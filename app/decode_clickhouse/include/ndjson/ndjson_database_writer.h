@@ -0,0 +1,90 @@
+#pragma once
+
+#include "../log-writer/database_writer.h"
+#include "ndjson_writer_options.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace decode_clickhouse {
+
+class NdjsonFile;
+
+/**
+ * Database writer implementation for newline-delimited JSON files
+ * Records are serialized straight into a buffer, one object per line with args embedded as a
+ * nested object, and the buffer is streamed through the optional gzip/zstd compressor to the open
+ * file. Files are rolled over at the configured size or age; closed files are named after their block range
+ */
+class NdjsonDatabaseWriter : public DatabaseWriter {
+public:
+    explicit NdjsonDatabaseWriter(const std::string& outputDir = "decoded_logs",
+                                  size_t batchSize = DEFAULT_BATCH_SIZE,
+                                  const NdjsonWriterOptions& options = NdjsonWriterOptions());
+    ~NdjsonDatabaseWriter() override;
+
+    std::string getName() const override;
+
+    /**
+     * Flush and close the open file
+     */
+    void close() override;
+
+    /**
+     * Remove the temporary files of an earlier run
+     */
+    void removeIncompleteOutput() override;
+
+    // Get the output directory
+    const std::string& getOutputDir() const { return outputDir_; }
+
+    // Create output directory if it doesn't exist
+    bool createOutputDirectory();
+
+protected:
+    bool writeBatch(const std::vector<ethereum_decoder::DecodedLogRecord>& records) override;
+    void onBatchWritten(size_t recordCount) override;
+    void onBatchFailed(size_t recordCount, const std::string& error) override;
+
+    // Records are only reported once the file holding them is closed
+    bool defersWrittenReport() const override { return true; }
+
+private:
+    // Serialize one record as a line into buffer_
+    void appendRecord(const ethereum_decoder::DecodedLogRecord& record);
+
+    // Hand the buffer to the open file, opening one if none is open
+    void flushBuffer();
+
+    void openFile();
+
+    // Write the buffer, finish the file and give it its block range name
+    void closeFile();
+
+    // Whether the open file has been open longer than the configured fileSeconds
+    bool fileExpired() const;
+
+    // Close the open file, if any; if that fails the writer stops, see DatabaseWriter::fail()
+    void finishFile();
+
+    // Give up on the open file after a failed write. It stays under its temporary name,
+    // its buffered records are dropped
+    void abandonFile();
+
+    std::string outputDir_;
+    NdjsonWriterOptions options_;
+    std::string extension_;  // File name suffix for the compression
+
+    std::string buffer_;
+    std::unique_ptr<NdjsonFile> file_;
+    std::string filePath_;         // Temporary name while the file is open
+    size_t fileSequence_ = 0;
+    size_t fileRows_ = 0;          // Records added to the open file, including the buffer
+    std::chrono::steady_clock::time_point fileStarted_;  // When the file's first record was added
+    uint64_t fileFirstBlock_ = 0;
+    uint64_t fileLastBlock_ = 0;
+    std::vector<LogPosition> filePositions_;  // Reported once the file is closed
+};
+
+} // namespace decode_clickhouse
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace decode_clickhouse {
+
+/**
+ * Compression and sizing of the rolling NDJSON output files
+ */
+struct NdjsonWriterOptions {
+    std::string compression = "none";       // File compression: none, gzip or zstd
+    size_t fileBytes = 256 * 1024 * 1024;   // Start a new file once a file has grown to this size on disk
+    size_t fileSeconds = 300;               // or has been open this long, 0 keeps it open until full
+};
+
+} // namespace decode_clickhouse
@@ -0,0 +1,89 @@
+#pragma once
+
+#ifdef ENABLE_PARQUET
+
+#include "parquet_dataset.h"
+#include <arrow/api.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace decode_clickhouse {
+
+/**
+ * Typed Arrow schema of one event: the log columns followed by one column per parameter,
+ * derived from the parameter's ABI type
+ *
+ *   address              -> fixed_size_binary(20)
+ *   uint8..uint64        -> uint64, int8..int64 -> int64
+ *   uint72..uint248      -> decimal256(76, 0), likewise for intN
+ *   uint256, int256      -> fixed_size_binary(32), big-endian two's complement
+ *   bool, string, bytes  -> bool, utf8, binary; bytesN -> fixed_size_binary(N)
+ *   T[], T[k]            -> list of the above
+ *   tuples, nested arrays -> utf8 holding the value as JSON
+ *
+ * Indexed string, bytes, array and tuple parameters only carry their topic hash and are stored
+ * as fixed_size_binary(32)
+ */
+class EventSchema {
+public:
+    explicit EventSchema(const ethereum_decoder::DecodedLogRecord& record);
+
+    /**
+     * Key of the record's layout: event signature and parameter names, types and indexed flags
+     * Records with the same key share a schema
+     */
+    static std::string layoutKey(const ethereum_decoder::DecodedLogRecord& record);
+
+    const std::shared_ptr<arrow::Schema>& schema() const { return schema_; }
+
+    /**
+     * Directory name for the event: its name and signature prefix
+     */
+    const std::string& datasetName() const { return datasetName_; }
+
+    /**
+     * Append the record's values to the dataset's columns
+     * Values that do not fit their column are stored as null
+     */
+    arrow::Status append(const ethereum_decoder::DecodedLogRecord& record, ParquetDataset& dataset) const;
+
+private:
+    enum class ValueKind {
+        Address,
+        UInt64,
+        Int64,
+        Decimal,
+        Word,
+        FixedBytes,
+        Bytes,
+        String,
+        Bool,
+        Json
+    };
+
+    struct ParamColumn {
+        ValueKind kind = ValueKind::Json;
+        bool list = false;
+        bool isSigned = false;
+        size_t byteWidth = 0;  // For Address, Word and FixedBytes
+    };
+
+    static ParamColumn columnFor(const ethereum_decoder::DecodedParam& param);
+    static std::shared_ptr<arrow::DataType> arrowType(const ParamColumn& column);
+
+    static arrow::Status appendValue(const ParamColumn& column, const ethereum_decoder::DecodedValue& value,
+                                     arrow::ArrayBuilder& builder);
+
+    // Array elements arrive in their text form
+    static arrow::Status appendElement(const ParamColumn& column, const std::string& element,
+                                       arrow::ArrayBuilder& builder);
+
+    std::shared_ptr<arrow::Schema> schema_;
+    std::string datasetName_;
+    std::vector<ParamColumn> columns_;
+};
+
+} // namespace decode_clickhouse
+
+#endif // ENABLE_PARQUET
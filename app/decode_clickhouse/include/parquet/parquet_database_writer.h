@@ -1,28 +1,46 @@
 #pragma once
 
+#ifdef ENABLE_PARQUET
+
 #include "../log-writer/database_writer.h"
+#include "event_schema.h"
+#include "parquet_dataset.h"
+#include "parquet_writer_options.h"
+#include <arrow/api.h>
 #include <string>
 #include <map>
 #include <memory>
 
-#ifdef ENABLE_PARQUET
-#include <arrow/api.h>
-#include <parquet/arrow/writer.h>
-#endif
-
 namespace decode_clickhouse {
 
 /**
  * Database writer implementation for Parquet files
- * Writes decoded logs to separate parquet files organized by block number
- * Uses JSON fallback when parquet support is not available
+ * Parquet output is appended to one open file in row groups and rolled over to a new file
+ * when it reaches the configured size or age; closed files are named after their block range.
+ * In per-event mode each event layout gets its own dataset under events/ with a typed column
+ * per parameter instead of the args JSON, see EventSchema.
+ * Only available with Arrow; NdjsonDatabaseWriter writes JSON instead
  */
 class ParquetDatabaseWriter : public DatabaseWriter {
 public:
-    explicit ParquetDatabaseWriter(const std::string& outputDir = "decoded_logs", 
+    explicit ParquetDatabaseWriter(const std::string& outputDir = "decoded_logs",
                                   size_t batchSize = DEFAULT_BATCH_SIZE,
-                                  bool forceJsonOutput = false);
-    ~ParquetDatabaseWriter() override = default;
+                                  const ParquetWriterOptions& options = ParquetWriterOptions());
+    ~ParquetDatabaseWriter() override;
+
+    std::string getName() const override;
+
+    bool needsDecodedParams() const override;
+
+    /**
+     * Flush and close the open Parquet files
+     */
+    void close() override;
+
+    /**
+     * Remove the temporary files of an earlier run, in the output directory and every event dataset
+     */
+    void removeIncompleteOutput() override;
 
     // Get the output directory
     const std::string& getOutputDir() const { return outputDir_; }
@@ -35,32 +53,55 @@ protected:
     void onBatchWritten(size_t recordCount) override;
     void onBatchFailed(size_t recordCount, const std::string& error) override;
 
+    // Parquet records are only reported once the file holding them is closed
+    bool defersWrittenReport() const override;
+
 private:
     std::string outputDir_;
-    bool forceJsonOutput_;  // Force JSON output even if Parquet is available
-    
-    // Group records by block number and write to separate files
-    void writeRecordsByBlock(const std::vector<ethereum_decoder::DecodedLogRecord>& records);
-    
-    // Write records for a specific block
-    bool writeBlockRecords(uint64_t blockNumber, const std::vector<ethereum_decoder::DecodedLogRecord>& records);
+    ParquetWriterOptions options_;
+
+    // Close the open Parquet files, if any; a file that fails to close is dropped and stops the writer
+    void finishFiles();
+
+    // Rows in a dataset's open file, from earlier batches and from the batch being appended
+    struct OpenRows {
+        size_t earlier = 0;
+        size_t batch = 0;
+    };
+
+    // Close the dataset's open file and collect its positions; false if it failed and was dropped.
+    // The counts are passed on to fail(): the file's rows written by earlier batches, and the
+    // rows of the current batch stored elsewhere
+    bool closeFile(ParquetDataset& dataset, std::vector<LogPosition>* positions, size_t lostRecords,
+                   size_t storedRecords = 0);
+
+    // Close the files open longer than the configured fileSeconds after a batch of batchRecords
+    // was appended with the given open rows; false if one failed
+    bool closeExpiredFiles(std::vector<LogPosition>* positions, const std::map<ParquetDataset*, OpenRows>& openRows,
+                           size_t batchRecords);
+
+    struct EventDataset {
+        std::unique_ptr<EventSchema> schema;
+        std::unique_ptr<ParquetDataset> dataset;
+    };
 
-#ifdef ENABLE_PARQUET
     // Create Arrow schema for DecodedLogRecord
     std::shared_ptr<arrow::Schema> createSchema();
-    
-    // Convert DecodedLogRecord vector to Arrow RecordBatch
-    std::shared_ptr<arrow::RecordBatch> createRecordBatch(const std::vector<ethereum_decoder::DecodedLogRecord>& logs);
-    
-    // Write records to parquet file
-    bool writeBlockRecordsAsParquet(uint64_t blockNumber, const std::vector<ethereum_decoder::DecodedLogRecord>& records);
-#endif
-    
-    // Get filename for a specific block
-    std::string getBlockFilename(uint64_t blockNumber) const;
-    
-    // Write records to JSON file as fallback
-    bool writeBlockRecordsAsJSON(uint64_t blockNumber, const std::vector<ethereum_decoder::DecodedLogRecord>& records);
+
+    // Add records to their datasets and report those in files closed on the way.
+    // Failing to create a dataset fails the batch before any record is added. A write error
+    // breaks the open file of its dataset: the file is dropped and the writer stops, see fail()
+    bool appendRecords(const std::vector<ethereum_decoder::DecodedLogRecord>& records);
+
+    // Dataset of the record's event layout, created on first use
+    EventDataset& eventDataset(const ethereum_decoder::DecodedLogRecord& record);
+
+    static arrow::Status appendRecord(const ethereum_decoder::DecodedLogRecord& record, ParquetDataset& dataset);
+
+    std::unique_ptr<ParquetDataset> dataset_;            // Records with the args JSON column
+    std::map<std::string, EventDataset> eventDatasets_;  // By EventSchema::layoutKey
 };
 
-} // namespace decode_clickhouse
\ No newline at end of file
+} // namespace decode_clickhouse
+
+#endif // ENABLE_PARQUET
@@ -0,0 +1,97 @@
+#pragma once
+
+#ifdef ENABLE_PARQUET
+
+#include "../log-writer/database_writer.h"
+#include "parquet_writer_options.h"
+#include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <parquet/arrow/writer.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace decode_clickhouse {
+
+/**
+ * Rows of one schema written to a directory as rolling Parquet files
+ * Rows are collected in column builders and written in row groups; a file is rolled over when it
+ * reaches the configured size or age and, once closed, named after the block range it holds.
+ * Compression, dictionary encoding and statistics follow the options, see ParquetWriterOptions
+ */
+class ParquetDataset {
+public:
+    ParquetDataset(std::string directory, std::shared_ptr<arrow::Schema> schema, const ParquetWriterOptions& options);
+
+    const std::shared_ptr<arrow::Schema>& schema() const { return schema_; }
+
+    /**
+     * Builder of a column of the row group being filled, by index in the schema
+     */
+    template <typename Builder>
+    Builder& column(int index) { return static_cast<Builder&>(*columns_[index]); }
+
+    /**
+     * Count the row whose values were just appended to every column
+     * Positions of rows in files closed on the way are added to closedPositions; without it
+     * positions are not kept
+     */
+    arrow::Status addRow(uint64_t blockNumber, uint64_t logIndex, std::vector<LogPosition>* closedPositions);
+
+    /**
+     * Write the remaining rows, close the file and give it its block range name
+     */
+    arrow::Status close(std::vector<LogPosition>* closedPositions);
+
+    /**
+     * Drop the open file and its buffered rows after a failed write
+     */
+    void discard();
+
+    /**
+     * Remove the temporary files a dataset in the directory left open in an earlier run,
+     * returns how many were removed
+     */
+    static size_t removeTemporaryFiles(const std::string& directory);
+
+    // Temporary name of the open file
+    const std::string& filePath() const { return filePath_; }
+
+    // Rows added to the open file, including the buffered row group
+    size_t fileRows() const { return fileRows_; }
+
+    /**
+     * True if the open file has held rows for the configured fileSeconds, it should be closed
+     * even though it is not full
+     */
+    bool expired(std::chrono::steady_clock::time_point now) const;
+
+private:
+    // Write the buffered rows as one row group, opening a file if none is open
+    arrow::Status writeRowGroup();
+
+    arrow::Status openFile();
+
+    std::string directory_;
+    std::shared_ptr<arrow::Schema> schema_;
+    ParquetWriterOptions options_;
+    std::shared_ptr<parquet::WriterProperties> properties_;  // Codec, dictionary and statistics per column
+
+    std::vector<std::unique_ptr<arrow::ArrayBuilder>> columns_;
+    size_t rowGroupRows_ = 0;
+
+    std::shared_ptr<arrow::io::FileOutputStream> file_;
+    std::unique_ptr<parquet::arrow::FileWriter> fileWriter_;
+    std::string filePath_;
+    size_t fileSequence_ = 0;
+    size_t fileRows_ = 0;
+    std::chrono::steady_clock::time_point fileStarted_;  // When the first row of the open file was added
+    uint64_t fileFirstBlock_ = 0;
+    uint64_t fileLastBlock_ = 0;
+    std::vector<LogPosition> filePositions_;  // Handed out once the file is closed
+};
+
+} // namespace decode_clickhouse
+
+#endif // ENABLE_PARQUET
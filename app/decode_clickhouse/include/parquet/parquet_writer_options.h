@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace decode_clickhouse {
+
+/**
+ * Layout, sizing and encoding of the rolling Parquet output files
+ */
+struct ParquetWriterOptions {
+    size_t fileRows = 1000000;              // Start a new file after this many rows
+    size_t fileBytes = 256 * 1024 * 1024;   // or once a file has grown to this size
+    size_t fileSeconds = 300;               // or has been open this long, 0 keeps it open until full
+    size_t rowGroupRows = 128 * 1024;       // Rows per row group
+    bool perEvent = false;                  // One dataset per event with typed parameter columns
+
+    std::string compression = "zstd";       // Column chunk codec: none, snappy, gzip, lz4 or zstd
+    std::optional<int> compressionLevel;    // Unset keeps the codec's default level
+
+    // Columns written with dictionary encoding, or every column with dictionaryAllColumns.
+    // Repetitive columns shrink to small indices; unique ones only pay for a dictionary that is discarded
+    std::vector<std::string> dictionaryColumns = {"contract_address", "event_name", "event_signature", "signature"};
+    bool dictionaryAllColumns = false;
+
+    // Columns with min/max statistics for predicate pushdown, or every column with statisticsAllColumns
+    std::vector<std::string> statisticsColumns = {"block_number", "log_index", "transaction_hash", "contract_address"};
+    bool statisticsAllColumns = false;
+};
+
+} // namespace decode_clickhouse
@@ -0,0 +1,35 @@
+#ifndef ETHEREUM_DECODER_BLOCK_COVERAGE_H
+#define ETHEREUM_DECODER_BLOCK_COVERAGE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace decode_clickhouse {
+
+// Set of the blocks seen within a block range, one bit per block relative to the range start.
+// Memory is fixed when it is created (1.25 MB per 10M blocks) and neither adding nor counting
+// takes a lock, so the progress display can read the count at any time.
+class BlockCoverage {
+public:
+    BlockCoverage(uint64_t startBlock, uint64_t endBlock);
+
+    BlockCoverage(const BlockCoverage&) = delete;
+    BlockCoverage& operator=(const BlockCoverage&) = delete;
+
+    // Safe from any number of threads; true the first time a block is added.
+    // Blocks outside the range are ignored
+    bool add(uint64_t block);
+
+    size_t count() const { return count_.load(std::memory_order_relaxed); }
+
+private:
+    uint64_t startBlock_;
+    uint64_t endBlock_;
+    std::unique_ptr<std::atomic<uint64_t>[]> words_;
+    std::atomic<size_t> count_{0};
+};
+
+} // namespace decode_clickhouse
+
+#endif // ETHEREUM_DECODER_BLOCK_COVERAGE_H
@@ -0,0 +1,87 @@
+#ifndef ETHEREUM_DECODER_CHECKPOINT_H
+#define ETHEREUM_DECODER_CHECKPOINT_H
+
+#include "../log-writer/database_writer.h"
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace decode_clickhouse {
+
+// Progress of a run as stored in the checkpoint file
+struct Checkpoint {
+    uint64_t startBlock = 0;
+    uint64_t endBlock = 0;
+    // Per writer name, the position up to which every log has been fetched, decoded and written
+    std::map<std::string, LogPosition> writers;
+
+    // Read a checkpoint file; false if it does not exist, throws if it cannot be parsed
+    static bool load(const std::string& path, Checkpoint& checkpoint);
+
+    // Replace the file atomically: written and synced to a temporary file, then renamed into place
+    void save(const std::string& path) const;
+};
+
+// Follows pages through decoding and writing and moves each writer's checkpoint position
+// once every log up to it has been written. Pages must be added in (blockNumber, logIndex)
+// order, so only ordered fetching can be checkpointed
+class CheckpointTracker {
+public:
+    // Positions in resumeFrom are kept for writers that find them again in writerNames
+    CheckpointTracker(const std::string& path, uint64_t startBlock, uint64_t endBlock,
+                      const std::vector<std::string>& writerNames, const Checkpoint* resumeFrom = nullptr);
+
+    // Where fetching continues: after the lowest writer position, unset if a writer starts over
+    std::optional<LogPosition> resumePosition() const;
+
+    // Position the writer had already written when the run started, if any
+    std::optional<LogPosition> writerResumePosition(size_t writerIndex) const;
+
+    // A page about to be decoded, with the position of its last log
+    void addPage(size_t pageNumber, const LogPosition& last);
+
+    // All logs of the page are decoded and produced this many records
+    void pageDecoded(size_t pageNumber, size_t records);
+
+    // Records the writer has stored, or skipped because it had written them before.
+    // Saves the checkpoint file when a writer position moves
+    void recordsWritten(size_t writerIndex, const std::vector<LogPosition>& positions);
+
+private:
+    struct PageState {
+        size_t pageNumber = 0;
+        LogPosition last;
+        bool decoded = false;
+        size_t records = 0;
+        std::vector<size_t> written;  // Per writer
+    };
+
+    // Move writer positions over completed pages; true if any moved
+    bool advance();
+
+    // Write the latest positions outside the lock; called without it held. Only one thread
+    // writes at a time, moves made meanwhile are coalesced into its next write.
+    // Failures are logged, the next move tries again
+    void save();
+
+    std::string path_;
+    std::vector<std::string> writerNames_;
+    std::vector<std::optional<LogPosition>> resumePositions_;
+
+    std::mutex mutex_;
+    Checkpoint checkpoint_;
+    std::deque<PageState> pages_;
+    std::vector<size_t> nextPage_;  // Per writer, the first page it has not completed
+
+    uint64_t version_ = 0;       // Bumped on every position move
+    uint64_t savedVersion_ = 0;  // Version last written to the file
+    bool saving_ = false;
+};
+
+} // namespace decode_clickhouse
+
+#endif // ETHEREUM_DECODER_CHECKPOINT_H
@@ -0,0 +1,129 @@
+#ifndef ETHEREUM_DECODER_DECODE_PIPELINE_H
+#define ETHEREUM_DECODER_DECODE_PIPELINE_H
+
+#include "block_coverage.h"
+#include "checkpoint.h"
+#include "mpsc_queue.h"
+#include "work_stealing_pool.h"
+#include "../clickhouse/clickhouse_ethereum.h"
+#include "../clickhouse/contract_abi_cache.h"
+#include "../log-writer/database_writer.h"
+#include "../progress_display.h"
+#include "../../../ethereum_decoder/include/ethereum_decoder.h"
+#include "../../../ethereum_decoder/include/decoding/signature_registry.h"
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace decode_clickhouse {
+
+// Fetch, decode and write as three concurrent stages:
+//
+//   streamLogs (calling thread) -> decode chunks on a work-stealing pool -> one writer thread per writer
+//
+// Each stage works on the next item while the following one is busy, so a run takes roughly
+// as long as its slowest stage. Decode workers collect records in their own buffer and hand
+// full buffers to every writer's queue at once, so workers never wait on each other to output.
+// Fetching waits while too many pages are still being decoded and decoding waits on a full
+// writer queue, which keeps memory bounded when a later stage cannot keep up.
+//
+// With a checkpoint tracker, pages and written batches are reported to it, and on a resumed run
+// each writer skips the records up to its checkpoint position. Records it wrote past that position
+// before the earlier run stopped are written again: output is at-least-once.
+class DecodePipeline {
+public:
+    DecodePipeline(ClickHouseEthereum& ethereum, ContractABICache& abiCache,
+                   std::vector<std::unique_ptr<DatabaseWriter>>& writers, ProgressDisplay& progress,
+                   size_t numWorkers, CheckpointTracker* checkpoint = nullptr);
+
+    // Process the block range; returns once every stage has drained.
+    // Writers still hold their last partial batch and must be flushed by the caller.
+    // If fetching failed, or stopped because a writer failed, the exception is rethrown after
+    // the stages drained
+    void run(uint64_t startBlock, uint64_t endBlock, const StreamOptions& options);
+
+    size_t getProcessedLogs() const { return processedLogs_.load(); }
+    size_t getDecodedLogs() const { return decodedLogs_.load(); }
+    size_t getProcessedBlocks() const;
+
+private:
+    // A fetched page with its logs grouped by contract and decoders resolved
+    struct Page {
+        size_t pageNumber = 0;
+        LogPage logs;
+        std::map<std::string, std::vector<const LogRecord*>, std::less<>> logsByContract;
+        std::map<std::string, ContractABICache::DecoderPtr> decoders;
+        std::atomic<size_t> remainingTasks{0};
+        std::atomic<size_t> processed{0};
+        std::atomic<size_t> decoded{0};
+    };
+
+    // A chunk of one contract's logs within a page. Large contracts are split into several
+    // chunks, so a page dominated by one token still spreads over all workers
+    struct DecodeTask {
+        std::shared_ptr<Page> page;
+        const std::string* address = nullptr;
+        const LogRecord* const* logs = nullptr;
+        size_t count = 0;
+        bool firstChunk = true;
+    };
+
+    using RecordBatch = std::vector<ethereum_decoder::DecodedLogRecord>;
+    using SharedBatch = std::shared_ptr<const RecordBatch>;
+
+    // Only touched by its own worker; padded so neighbouring buffers never share a cache line
+    struct alignas(64) WorkerBuffer {
+        RecordBatch records;
+    };
+
+    std::shared_ptr<Page> preparePage(LogPage& pageResults, size_t pageNumber);
+    void submitPage(const std::shared_ptr<Page>& page);
+    void writeWorker(size_t writerIndex);
+    void progressWorker();
+
+    // Send the buffered records to every writer and start a new buffer
+    void handOff(RecordBatch& records);
+
+    void runTask(const DecodeTask& task);
+    void decodeTask(const DecodeTask& task, RecordBatch& records);
+    void finishTask(Page& page);
+
+    ClickHouseEthereum& ethereum_;
+    ContractABICache& abiCache_;
+    std::vector<std::unique_ptr<DatabaseWriter>>& writers_;
+    ProgressDisplay& progress_;
+    size_t numWorkers_;
+    CheckpointTracker* checkpoint_;
+    bool keepDecodedParams_ = false;  // Some writer stores typed parameters
+
+    // Events learned from any contract ABI, used for contracts that have none
+    ethereum_decoder::SignatureRegistry& signatureRegistry_;
+    ethereum_decoder::EthereumDecoder registryDecoder_;
+
+    std::vector<WorkerBuffer> workerBuffers_;
+    std::vector<std::unique_ptr<MpscQueue<SharedBatch>>> writerQueues_;
+
+    // Pages handed to the pool whose chunks have not all finished
+    std::mutex pagesMutex_;
+    std::condition_variable pagesCondition_;
+    size_t pagesInFlight_ = 0;
+
+    std::atomic<size_t> currentPage_{0};
+    std::atomic<size_t> processedLogs_{0};
+    std::atomic<size_t> decodedLogs_{0};
+    std::atomic<bool> running_{false};
+
+    // Blocks with at least one fetched log, set up for the range of each run
+    std::unique_ptr<BlockCoverage> processedBlocks_;
+
+    // Last member: destroyed first, so its workers stop before the state they use goes away
+    WorkStealingPool pool_;
+};
+
+} // namespace decode_clickhouse
+
+#endif // ETHEREUM_DECODER_DECODE_PIPELINE_H
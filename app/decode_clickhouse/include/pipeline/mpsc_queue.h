@@ -0,0 +1,138 @@
+#ifndef ETHEREUM_DECODER_MPSC_QUEUE_H
+#define ETHEREUM_DECODER_MPSC_QUEUE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace decode_clickhouse {
+
+// Multi-producer, single-consumer queue. Producers link nodes in with a single atomic
+// exchange and never take a lock while the queue has room and the consumer is awake;
+// the mutex is only used to put the consumer or a producer facing a full queue to sleep.
+//
+// The capacity is a soft bound: producers racing past the check can overshoot it by at
+// most one item each.
+template <typename T>
+class MpscQueue {
+public:
+    explicit MpscQueue(size_t capacity) : capacity_(capacity > 0 ? capacity : 1) {
+        Node* stub = new Node();
+        head_.store(stub);
+        tail_ = stub;
+    }
+
+    ~MpscQueue() {
+        Node* node = tail_;
+        while (node) {
+            Node* next = node->next.load();
+            delete node;
+            node = next;
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    // Safe from any number of threads; blocks while the queue is full.
+    // Returns false if the queue was closed, the item is dropped then
+    bool push(T value) {
+        if (size_.load() >= capacity_) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            producersWaiting_++;
+            notFull_.wait(lock, [this] { return closed_.load() || size_.load() < capacity_; });
+            producersWaiting_--;
+        }
+        if (closed_.load()) {
+            return false;
+        }
+
+        size_++;
+        Node* node = new Node();
+        node->value = std::move(value);
+        Node* previous = head_.exchange(node);
+        previous->next.store(node, std::memory_order_release);
+
+        // The consumer sets consumerWaiting_ before re-checking head_, so either it sees
+        // this node or we see the flag and wake it up
+        if (consumerWaiting_.load()) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            notEmpty_.notify_one();
+        }
+        return true;
+    }
+
+    // Only one thread may pop. Blocks until an item arrives; returns false once the
+    // queue is closed and drained
+    bool pop(T& value) {
+        while (true) {
+            if (tryPop(value)) {
+                size_--;
+                if (producersWaiting_.load() > 0) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    notFull_.notify_all();
+                }
+                return true;
+            }
+
+            // A producer swapped in a node but has not linked it yet
+            if (head_.load() != tail_) {
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            consumerWaiting_ = true;
+            notEmpty_.wait(lock, [this] { return head_.load() != tail_ || closed_.load(); });
+            consumerWaiting_ = false;
+            if (head_.load() == tail_) {
+                return false;
+            }
+        }
+    }
+
+    // No more items will be pushed; the consumer drains what is left
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+    }
+
+private:
+    struct Node {
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    bool tryPop(T& value) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return false;
+        }
+        // next becomes the new stub once its value is taken
+        value = std::move(next->value);
+        next->value = T();
+        tail_ = next;
+        delete tail;
+        return true;
+    }
+
+    const size_t capacity_;
+    std::atomic<Node*> head_;  // Most recently pushed node
+    Node* tail_;  // Stub before the oldest item, owned by the consumer
+
+    std::atomic<size_t> size_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> consumerWaiting_{false};
+    std::atomic<size_t> producersWaiting_{0};
+    std::mutex mutex_;
+    std::condition_variable notEmpty_;
+    std::condition_variable notFull_;
+};
+
+} // namespace decode_clickhouse
+
+#endif // ETHEREUM_DECODER_MPSC_QUEUE_H
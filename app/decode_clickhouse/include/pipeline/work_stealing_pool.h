@@ -0,0 +1,75 @@
+#ifndef ETHEREUM_DECODER_WORK_STEALING_POOL_H
+#define ETHEREUM_DECODER_WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace decode_clickhouse {
+
+// Fixed set of worker threads that live as long as the pool. Every worker owns a task deque:
+// it takes its own tasks from the back and, once that runs dry, steals from the front of the
+// others. Workers only touch each other's deques when they are out of work, so the common
+// path never contends on a shared lock.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit WorkStealingPool(size_t numWorkers);
+
+    // Runs the tasks still queued, then joins the workers
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    // Tasks submitted from a worker go to its own deque, others are spread round-robin
+    void submit(Task task);
+
+    // Spread a batch evenly over all deques, so idle workers start without stealing
+    void submitAll(std::vector<Task> tasks);
+
+    // Block until every task submitted so far has finished
+    void wait();
+
+    size_t size() const { return queues_.size(); }
+
+    // Index of the calling worker thread, or size() when called from outside the pool
+    size_t currentWorker() const;
+    size_t getActiveWorkers() const { return active_.load(); }
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    void push(size_t index, Task task);
+    bool popOwn(size_t index, Task& task);
+    bool steal(size_t index, Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    // Only taken to sleep and wake up, never to hand out a task
+    std::mutex wakeMutex_;
+    std::condition_variable wakeCondition_;
+    std::condition_variable idleCondition_;
+    std::atomic<size_t> sleepers_{0};
+    bool stopping_ = false;  // Guarded by wakeMutex_
+
+    std::atomic<size_t> queued_{0};  // Tasks sitting in deques
+    std::atomic<size_t> pending_{0};  // Tasks queued or running
+    std::atomic<size_t> active_{0};
+    std::atomic<size_t> nextQueue_{0};
+};
+
+} // namespace decode_clickhouse
+
+#endif // ETHEREUM_DECODER_WORK_STEALING_POOL_H
@@ -1,13 +1,16 @@
 #include "include/decode_clickhouse_arg_parser.h"
 #include "include/clickhouse/clickhouse_client.h"
 #include "include/clickhouse/clickhouse_ethereum.h"
-#include "../ethereum_decoder/include/decoding/abi_parser.h"
+#include "include/clickhouse/contract_abi_cache.h"
 #include "../ethereum_decoder/include/ethereum_decoder.h"
-#include "../ethereum_decoder/include/json/json_decoder.h"
+#include "../ethereum_decoder/include/decoding/signature_registry.h"
 #include "include/progress_display.h"
 #include "include/log-writer/database_writer.h"
 #include "include/log-writer/clickhouse_writer.h"
+#include "include/ndjson/ndjson_database_writer.h"
 #include "include/parquet/parquet_database_writer.h"
+#include "include/pipeline/checkpoint.h"
+#include "include/pipeline/decode_pipeline.h"
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <iostream>
@@ -17,7 +20,6 @@
 #include <atomic>
 #include <mutex>
 #include <map>
-#include <set>
 #include <chrono>
 #include <sstream>
 
@@ -41,6 +43,12 @@ int run(int argc, char *argv[]) {
             return 0;
         }
 
+#ifdef ENABLE_PARQUET
+        const bool parquetOutput = !args.useJsonOutput;
+#else
+        const bool parquetOutput = false;
+#endif
+
         try {
             auto file_sink = std::make_shared<spdlog::sinks::basic_file_sink_mt>(args.logFile, true);
             auto logger = std::make_shared<spdlog::logger>("file_logger", file_sink);
@@ -87,10 +95,28 @@ int run(int argc, char *argv[]) {
         spdlog::info("Parallel workers: {}", args.parallelWorkers);
         spdlog::info("Insert decoded logs: {}", args.insertDecodedLogs ? "enabled" : "disabled");
         spdlog::info("Output directory: {}", args.outputDir);
-        spdlog::info("Output format: {}", args.useJsonOutput ? "JSON" : "Parquet");
+        spdlog::info("Output format: {}", parquetOutput ? "Parquet" : "NDJSON");
+        if (parquetOutput) {
+            spdlog::info("Parquet files: {} rows, {} MB or {} s, row groups of {} rows", args.parquet.fileRows,
+                         args.parquet.fileBytes / (1024 * 1024), args.parquet.fileSeconds, args.parquet.rowGroupRows);
+            spdlog::info("Parquet layout: {}", args.parquet.perEvent ? "one dataset per event" : "single dataset");
+            spdlog::info("Parquet compression: {}{}", args.parquet.compression,
+                         args.parquet.compressionLevel ? " level " + std::to_string(*args.parquet.compressionLevel) : "");
+        } else {
+            spdlog::info("JSON files: {} MB or {} s, compression: {}", args.json.fileBytes / (1024 * 1024),
+                         args.json.fileSeconds, args.json.compression);
+        }
         spdlog::info("Log file: {}", args.logFile);
         spdlog::info("Log level: {}", args.logLevel);
         spdlog::info("Logs page size: {}", args.logsPageSize);
+        spdlog::info("ABI cache size: {}", args.abiCacheSize);
+        spdlog::info("ABI snapshot: {}", args.abiSnapshotPath.empty() ? "disabled" : args.abiSnapshotPath);
+        spdlog::info("Fetch shards: {} x {} blocks ({})", args.fetchShards, args.shardBlocks,
+                     args.unorderedFetch ? "unordered" : "ordered");
+        spdlog::info("Log fetch format: {}", args.binaryLogs ? "binary" : "hex");
+        spdlog::info("Write batches in flight: {}", args.writeBatchesInFlight);
+        spdlog::info("Compression: {} (inserts: {})", args.config.compression, args.config.getInsertCompression());
+        spdlog::info("Resume from checkpoint: {}", args.resume ? "enabled" : "disabled");
 
         decode_clickhouse::ClickHouseClient clickhouseClient(args.config);
         decode_clickhouse::ClickHouseEthereum ethereum(clickhouseClient);
@@ -119,258 +145,158 @@ int run(int argc, char *argv[]) {
             return 1;
         }
 
+        // Declared before the writers: their destructors may still report written batches to it
+        std::unique_ptr<decode_clickhouse::CheckpointTracker> checkpoint;
         std::vector<std::unique_ptr<decode_clickhouse::DatabaseWriter>> writers;
 
-        // Create file writer - ParquetDatabaseWriter handles both Parquet and JSON output
+        // Create file writer - Parquet when built with Arrow, NDJSON otherwise or with --json
         size_t batchSize = 1000 * static_cast<size_t>(args.parallelWorkers);
-        auto fileWriter = std::make_unique<decode_clickhouse::ParquetDatabaseWriter>(args.outputDir, batchSize, args.useJsonOutput);
-        writers.push_back(std::move(fileWriter));
+        if (parquetOutput) {
+#ifdef ENABLE_PARQUET
+            writers.push_back(std::make_unique<decode_clickhouse::ParquetDatabaseWriter>(args.outputDir, batchSize,
+                                                                                         args.parquet));
+#endif
+        } else {
+            writers.push_back(std::make_unique<decode_clickhouse::NdjsonDatabaseWriter>(args.outputDir, batchSize,
+                                                                                        args.json));
+        }
         
         if (args.insertDecodedLogs) {
-            auto ethereumPtr = std::make_shared<decode_clickhouse::ClickHouseEthereum>(ethereum);
+            auto ethereumPtr = std::make_shared<decode_clickhouse::ClickHouseEthereum>(clickhouseClient);
+            // Checkpointed rows must be in the table, not just in the server's async insert buffer
+            ethereumPtr->setWaitForAsyncInsert(!args.unorderedFetch);
             writers.push_back(std::make_unique<decode_clickhouse::ClickhouseWriter>(ethereumPtr));
         }
+
+        // Batches are written on each writer's own flush thread, so writing never stalls the pipeline
+        for (auto& writer : writers) {
+            writer->enableAsyncFlush(args.writeBatchesInFlight);
+        }
         
-        std::atomic<size_t> totalProcessedLogs{0};
-        std::atomic<size_t> totalDecodedLogs{0};
-        std::set<uint64_t> processedBlocks;
-        std::mutex processedBlocksMutex;
+        // Parsed ABIs survive across pages, so only unseen contracts hit ClickHouse
+        decode_clickhouse::ContractABICache abiCache(args.abiCacheSize, args.abiSnapshotPath);
+        auto& signatureRegistry = ethereum_decoder::SignatureRegistry::global();
 
         progress.setStatus("Streaming & decoding logs");
 
-        auto processPage = [&](std::vector<decode_clickhouse::LogRecord> &pageResults, size_t pageNumber, size_t totalProcessed) {
-            // Track unique blocks in this page
-            {
-                std::lock_guard<std::mutex> lock(processedBlocksMutex);
-                for (const auto& log : pageResults) {
-                    processedBlocks.insert(log.blockNumber);
-                }
-            }
-            
-            size_t blocksProcessedCount = 0;
-            {
-                std::lock_guard<std::mutex> lock(processedBlocksMutex);
-                blocksProcessedCount = processedBlocks.size();
-            }
-            
-            progress.updateProgress(pageNumber, totalProcessed, totalDecodedLogs.load(), blocksProcessedCount);
-            progress.setStatus("Decoding");
-
-            spdlog::info("Processing page {} with {} logs (total fetched: {})", pageNumber, pageResults.size(),
-                         totalProcessed);
+        decode_clickhouse::StreamOptions streamOptions;
+        streamOptions.shards = args.fetchShards;
+        streamOptions.shardBlocks = args.shardBlocks;
+        streamOptions.ordered = !args.unorderedFetch;
+        streamOptions.binary = args.binaryLogs;
 
-            std::map<std::string, std::vector<decode_clickhouse::LogRecord *> > logsByContract;
-            for (auto &log : pageResults) {
-                logsByContract[log.address].push_back(&log);
+        // Checkpoints follow pages in block order, which unordered fetching does not keep
+        uint64_t fetchStartBlock = args.blockRange.start;
+        if (args.unorderedFetch) {
+            spdlog::info("Checkpoints: disabled with --unordered");
+        } else {
+            std::string checkpointPath = args.checkpointFile.empty() ? args.outputDir + "/.checkpoint.json"
+                                                                     : args.checkpointFile;
+            std::vector<std::string> writerNames;
+            for (const auto& writer : writers) {
+                writerNames.push_back(writer->getName());
             }
 
-            // Fetch ABIs for all contracts in this page batch
-            std::vector<std::string> contractAddresses;
-            for (const auto& [address, logs] : logsByContract) {
-                contractAddresses.push_back(address);
-            }
-            
-            auto contractABIs = ethereum.getBatchContractABI(contractAddresses);
-            spdlog::debug("Fetched ABIs for {} out of {} contracts", contractABIs.size(), contractAddresses.size());
-
-            std::atomic<size_t> pageProcessedCount{0};
-            std::atomic<size_t> pageDecodedCount{0};
-            std::atomic<size_t> activeWorkerCount{0};
-            std::mutex writersMutex;
-
-            // Spawn workers, but limit them to max number of logs per contract to avoid idle threads
-            std::vector<std::thread> workers;
-            size_t numWorkers = std::min(static_cast<size_t>(args.parallelWorkers), logsByContract.size());
-
-            auto contractIterator = logsByContract.begin();
-            std::mutex contractMutex;
-
-            for (size_t workerId = 0; workerId < numWorkers; ++workerId) {
-                workers.emplace_back([&]() {
-                    while (true) {
-                        std::string contractAddress;
-                        std::vector<decode_clickhouse::LogRecord *> contractLogs;
-
-                        {
-                            std::lock_guard<std::mutex> lock(contractMutex);
-                            if (contractIterator == logsByContract.end()) {
-                                break;
-                            }
-                            contractAddress = contractIterator->first;
-                            contractLogs = contractIterator->second;
-                            ++contractIterator;
-                        }
-                        
-                        // Increment active worker count
-                        activeWorkerCount++;
-
-                        // Check if we have ABI for this contract
-                        auto abiIt = contractABIs.find(contractAddress);
-                        if (abiIt == contractABIs.end()) {
-                            spdlog::debug("No ABI found for contract {}, skipping {} logs",
-                                        contractAddress, contractLogs.size());
-                            pageProcessedCount += contractLogs.size();
-                            activeWorkerCount--;  // Decrement before continuing
-                            continue;
-                        }
-
-                        ethereum_decoder::ABIParser abiParser;
-                        
-                        try {
-                            // Parse ABI from ClickHouse data
-                            auto abi = abiParser.parseFromString(abiIt->second.abi);
-                            ethereum_decoder::EthereumDecoder decoder(std::move(abi));
-                            ethereum_decoder::JsonDecoder jsonDecoder;
-
-                        for (auto *logPtr : contractLogs) {
-                            pageProcessedCount++;
-
-                            ethereum_decoder::LogEntry logEntry;
-                            logEntry.address = logPtr->address;
-                            logEntry.topics.clear();
-                            if (!logPtr->topic0.empty()) logEntry.topics.push_back(logPtr->topic0);
-                            if (!logPtr->topic1.empty()) logEntry.topics.push_back(logPtr->topic1);
-                            if (!logPtr->topic2.empty()) logEntry.topics.push_back(logPtr->topic2);
-                            if (!logPtr->topic3.empty()) logEntry.topics.push_back(logPtr->topic3);
-                            logEntry.data = logPtr->data;
-
-                            try {
-                                auto decodedLogs = decoder.decodeLogs({logEntry});
-                                if (decodedLogs.empty()) {
-                                    spdlog::debug("Decoder returned empty result for log at block {} index {}", 
-                                                logPtr->blockNumber, logPtr->logIndex);
-                                    continue;
-                                }
-
-                                auto& decodedLog = decodedLogs[0];
-
-                                ethereum_decoder::DecodedLogRecord decodedLogRecord;
-                                decodedLogRecord.transactionHash = logPtr->transactionHash;
-                                decodedLogRecord.blockNumber = logPtr->blockNumber;
-                                decodedLogRecord.logIndex = logPtr->logIndex;
-                                decodedLogRecord.contractAddress = logPtr->address;
-                                decodedLogRecord.eventName = decodedLog->eventName;
-                                decodedLogRecord.eventSignature = decodedLog->eventSignature;
-
-                                try {
-                                    auto jsonResult = jsonDecoder.decodedLogToJson(*decodedLog);
-                                    decodedLogRecord.args = jsonResult.dump();
-                                } catch (const std::exception &json_e) {
-                                    decodedLogRecord.args = "{\"error\": \"JSON conversion failed: " + std::string(json_e.what()) +
-                                                  "\"}";
-                                }
-
-                                {
-                                    std::lock_guard<std::mutex> lock(writersMutex);
-                                    for (auto& writer : writers) {
-                                        writer->write(decodedLogRecord);
-                                    }
-                                }
-                                
-                                ++pageDecodedCount;
-
-                            } catch (const std::exception &e) {
-                                // Log decoding error for debugging
-                                spdlog::debug("Failed to decode log: {}", e.what());
-                                continue;
-                            }
-                        }
-                        } catch (const std::exception &e) {
-                            spdlog::error("Failed to parse ABI for contract {}: {}", contractAddress, e.what());
-                            pageProcessedCount += contractLogs.size();
-                            activeWorkerCount--;  // Decrement before continuing
-                            continue;
-                        }
-                        
-                        // Decrement active worker count after processing
-                        activeWorkerCount--;
-                    }
-                });
-            }
+            try {
+                decode_clickhouse::Checkpoint previous;
+                bool resuming = args.resume && decode_clickhouse::Checkpoint::load(checkpointPath, previous);
+                if (args.resume && !resuming) {
+                    spdlog::warn("No checkpoint found at {}, starting at block {}", checkpointPath,
+                                 args.blockRange.start);
+                }
+                if (resuming && (previous.startBlock != args.blockRange.start ||
+                                 previous.endBlock != args.blockRange.end)) {
+                    throw std::runtime_error("checkpoint " + checkpointPath + " is for blocks " +
+                                             std::to_string(previous.startBlock) + "-" +
+                                             std::to_string(previous.endBlock));
+                }
 
-            // Update progress periodically while workers are running
-            std::thread progressUpdater([&]() {
-                while (true) {
-                    size_t activeWorkers = activeWorkerCount.load();
-                    if (activeWorkers == 0) {
-                        // Check if all workers have finished
-                        bool allFinished = true;
-                        for (const auto& worker : workers) {
-                            if (worker.joinable()) {
-                                allFinished = false;
-                                break;
-                            }
-                        }
-                        if (allFinished) break;
-                    }
-                    
-                    size_t blocksCount = 0;
-                    {
-                        std::lock_guard<std::mutex> lock(processedBlocksMutex);
-                        blocksCount = processedBlocks.size();
+                checkpoint = std::make_unique<decode_clickhouse::CheckpointTracker>(
+                    checkpointPath, args.blockRange.start, args.blockRange.end, writerNames,
+                    resuming ? &previous : nullptr);
+
+                // Files the earlier run never closed are past the checkpoint and written again
+                if (args.resume) {
+                    for (auto& writer : writers) {
+                        writer->removeIncompleteOutput();
                     }
-                    
-                    progress.updateProgress(pageNumber, totalProcessedLogs.load(), totalDecodedLogs.load(), 
-                                          blocksCount, activeWorkers);
-                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
                 }
-            });
-
-            for (auto &worker: workers) {
-                worker.join();
+            } catch (const std::exception &e) {
+                progress.stop();
+                spdlog::error("Failed to load checkpoint: {}", e.what());
+                return 1;
             }
-            
-            progressUpdater.join();
-
-            totalProcessedLogs += pageProcessedCount;
-            totalDecodedLogs += pageDecodedCount;
 
-            size_t finalBlocksCount = 0;
-            {
-                std::lock_guard<std::mutex> lock(processedBlocksMutex);
-                finalBlocksCount = processedBlocks.size();
+            if (auto position = checkpoint->resumePosition()) {
+                fetchStartBlock = position->blockNumber;
+                streamOptions.startLogIndex = position->logIndex + 1;
+                spdlog::info("Resuming after block {} log index {}", position->blockNumber, position->logIndex);
             }
-            progress.updateProgress(pageNumber, totalProcessedLogs.load(), totalDecodedLogs.load(), finalBlocksCount);
+            spdlog::info("Checkpoint file: {}", checkpointPath);
+        }
 
-            float decodeRate = pageProcessedCount > 0 ? 
-                               (static_cast<float>(pageDecodedCount.load()) / pageProcessedCount.load() * 100.0f) : 0.0f;
-            spdlog::info("  ✓ Page {}: processed {} logs, decoded {} ({:.1f}% success rate)", 
-                         pageNumber, pageProcessedCount.load(), pageDecodedCount.load(), decodeRate);
-        };
+        decode_clickhouse::DecodePipeline pipeline(ethereum, abiCache, writers, progress,
+                                                   static_cast<size_t>(args.parallelWorkers), checkpoint.get());
+        // Records decoded before a fetch failure are still flushed and checkpointed below
+        bool streamFailed = false;
+        try {
+            pipeline.run(fetchStartBlock, args.blockRange.end, streamOptions);
+        } catch (const std::exception &e) {
+            spdlog::error("Log streaming failed: {}", e.what());
+            streamFailed = true;
+        }
 
-        ethereum.streamLogs(args.blockRange.start, args.blockRange.end, processPage);
+        size_t totalProcessedLogs = pipeline.getProcessedLogs();
+        size_t totalDecodedLogs = pipeline.getDecodedLogs();
 
-        progress.setStatus("Streaming completed");
-        size_t totalBlocksProcessed = 0;
-        {
-            std::lock_guard<std::mutex> lock(processedBlocksMutex);
-            totalBlocksProcessed = processedBlocks.size();
-        }
-        progress.updateProgress(0, totalProcessedLogs.load(), totalDecodedLogs.load(), totalBlocksProcessed);
+        progress.setStatus(streamFailed ? "Streaming failed" : "Streaming completed");
+        progress.updateProgress(0, totalProcessedLogs, totalDecodedLogs, pipeline.getProcessedBlocks());
         progress.stop();
 
-        spdlog::info("\n✓ Streaming completed: processed {} logs, successfully decoded {}", totalProcessedLogs.load(),
-                     totalDecodedLogs.load());
+        if (streamFailed) {
+            spdlog::error("\nStreaming stopped early: processed {} logs, successfully decoded {}",
+                          totalProcessedLogs, totalDecodedLogs);
+        } else {
+            spdlog::info("\n✓ Streaming completed: processed {} logs, successfully decoded {}", totalProcessedLogs,
+                         totalDecodedLogs);
+        }
 
         spdlog::info("\nFlushing all writers...");
         for (auto& writer : writers) {
-            writer->flush();
+            writer->close();
+        }
+        
+        try {
+            abiCache.saveSnapshot();
+        } catch (const std::exception &e) {
+            spdlog::warn("Failed to update ABI snapshot: {}", e.what());
         }
         
         spdlog::info("\n✓ Writer Statistics:");
+        bool writeFailed = false;
         for (const auto& writer : writers) {
-            spdlog::info("  Written: {} records, Failed: {} records", 
-                        writer->getTotalWritten(), 
-                        writer->getTotalWritten() + writer->getPendingCount() - writer->getTotalWritten());
+            spdlog::info("  Written: {} records, Failed: {} records",
+                        writer->getTotalWritten(),
+                        writer->getTotalFailed());
+            writeFailed = writeFailed || writer->hasFailed() || writer->getTotalFailed() > 0;
+        }
+
+        if (streamFailed || writeFailed) {
+            spdlog::error("Block range {}-{} was not fully processed", args.blockRange.start, args.blockRange.end);
+            if (checkpoint) {
+                spdlog::error("Run again with --resume to continue after the checkpoint");
+            }
+            return 1;
         }
 
         float totalDecodeRate = totalProcessedLogs > 0 ? 
-                               (static_cast<float>(totalDecodedLogs.load()) / totalProcessedLogs.load() * 100.0f) : 0.0f;
+                               (static_cast<float>(totalDecodedLogs) / totalProcessedLogs * 100.0f) : 0.0f;
         spdlog::info("\n✓ Streaming log processing completed successfully");
-        spdlog::info("  Total processed: {} logs", totalProcessedLogs.load());
-        spdlog::info("  Total decoded: {} logs ({:.1f}% success rate)", totalDecodedLogs.load(), totalDecodeRate);
+        spdlog::info("  Total processed: {} logs", totalProcessedLogs);
+        spdlog::info("  Total decoded: {} logs ({:.1f}% success rate)", totalDecodedLogs, totalDecodeRate);
         spdlog::info("  Total skipped: {} logs (no ABI or decode failure)", 
-                     totalProcessedLogs.load() - totalDecodedLogs.load());
+                     totalProcessedLogs - totalDecodedLogs);
+        spdlog::info("  Known event signatures: {}", signatureRegistry.size());
         if (args.insertDecodedLogs) {
             spdlog::info("  ClickHouse insertion: enabled (batched)");
         } else {
@@ -1,16 +1,28 @@
 #include "include/clickhouse/clickhouse_client.h"
 #include <spdlog/spdlog.h>
 #include <sstream>
+#include <stdexcept>
 #include <algorithm>
 
 namespace decode_clickhouse {
 
+    clickhouse::CompressionMethod parseCompressionMethod(const std::string& name) {
+        if (name == "none") {
+            return clickhouse::CompressionMethod::None;
+        } else if (name == "lz4") {
+            return clickhouse::CompressionMethod::LZ4;
+        } else if (name == "zstd") {
+            return clickhouse::CompressionMethod::ZSTD;
+        }
+        throw std::runtime_error("Unknown compression method: " + name + " (expected none, lz4 or zstd)");
+    }
+
     // ClickHouseConnectionPool implementation
     ClickHouseConnectionPool::ClickHouseConnectionPool(const ClickHouseConfig& config, size_t poolSize)
         : config_(config), poolSize_(poolSize) {
         // Pre-populate the pool with connections
         for (size_t i = 0; i < poolSize_; ++i) {
-            connections_.push(createConnection());
+            connections_.push(createConnection(config_.compression));
         }
     }
 
@@ -21,7 +33,7 @@ namespace decode_clickhouse {
         }
     }
 
-    std::shared_ptr<clickhouse::Client> ClickHouseConnectionPool::createConnection() {
+    std::shared_ptr<clickhouse::Client> ClickHouseConnectionPool::createConnection(const std::string& compression) {
         clickhouse::ClientOptions options;
         options.SetHost(config_.host);
         options.SetPort(config_.port);
@@ -45,7 +57,7 @@ namespace decode_clickhouse {
             }
         }
 
-        options.SetCompressionMethod(clickhouse::CompressionMethod::None);
+        options.SetCompressionMethod(parseCompressionMethod(compression));
         options.SetConnectionConnectTimeout(std::chrono::seconds(30));
         options.SetConnectionRecvTimeout(std::chrono::seconds(30));
         options.SetConnectionSendTimeout(std::chrono::seconds(30));
@@ -105,8 +117,7 @@ namespace decode_clickhouse {
             }
         }
 
-        // Use lighter compression to reduce connection issues
-        options.SetCompressionMethod(clickhouse::CompressionMethod::None);
+        options.SetCompressionMethod(parseCompressionMethod(config_.compression));
 
         // Increase timeouts for cloud connections
         options.SetConnectionConnectTimeout(std::chrono::seconds(30));
@@ -2,6 +2,11 @@
 #include <spdlog/spdlog.h>
 #include <sstream>
 #include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
 
 namespace decode_clickhouse {
 
@@ -15,10 +20,18 @@ namespace decode_clickhouse {
         queryConfig_.loadFromFiles(sqlConfigDir);
     }
 
-    void ClickHouseEthereum::streamLogs(uint64_t startBlock, uint64_t endBlock, 
-                                       std::function<void(std::vector<LogRecord>&, size_t pageNumber, size_t totalProcessed)> callback) {
+    void ClickHouseEthereum::streamLogs(uint64_t startBlock, uint64_t endBlock, PageCallback callback,
+                                        const StreamOptions& options) {
+        if (options.shards > 1) {
+            streamLogsSharded(startBlock, endBlock, callback, options);
+            return;
+        }
+
         const size_t PAGE_SIZE = queryConfig_.getPageSize();
-        size_t offset = 0;
+        // Keyset cursor: the first (blockNumber, logIndex) of the next page. Unlike OFFSET,
+        // ClickHouse can skip straight to it, so deep pages cost the same as the first
+        uint64_t cursorBlock = startBlock;
+        uint64_t cursorLogIndex = options.startLogIndex;
         size_t totalProcessed = 0;
         size_t pageNumber = 1;
 
@@ -26,131 +39,286 @@ namespace decode_clickhouse {
 
         try {
             while (true) {
-                std::vector<LogRecord> pageResults;
-                
-                // Use configurable query
-                std::string queryStr = queryConfig_.formatLogStreamQuery(startBlock, endBlock, PAGE_SIZE, offset);
-
-                size_t pageLogsCount = 0;
-
-                client->Select(queryStr, [&pageResults, &pageLogsCount](const clickhouse::Block &block) {
-                    try {
-                        for (size_t i = 0; i < block.GetRowCount(); ++i) {
-                            LogRecord log;
-
-                            try {
-                                log.transactionHash = block[0]->As<clickhouse::ColumnString>()->At(i);
-                                
-                                auto typeCode = block[1]->GetType().GetCode();
-                                if (typeCode == clickhouse::Type::Code::UInt64) {
-                                    log.blockNumber = block[1]->As<clickhouse::ColumnUInt64>()->At(i);
-                                } else if (typeCode == clickhouse::Type::Code::UInt32) {
-                                    log.blockNumber = block[1]->As<clickhouse::ColumnUInt32>()->At(i);
-                                } else if (typeCode == clickhouse::Type::Code::Int64) {
-                                    log.blockNumber = block[1]->As<clickhouse::ColumnInt64>()->At(i);
-                                } else {
-                                }
-                                
-                                log.address = block[2]->As<clickhouse::ColumnString>()->At(i);
-                                log.data = block[3]->As<clickhouse::ColumnString>()->At(i);
-                                
-                                auto logIndexTypeCode = block[4]->GetType().GetCode();
-                                if (logIndexTypeCode == clickhouse::Type::Code::UInt64) {
-                                    log.logIndex = block[4]->As<clickhouse::ColumnUInt64>()->At(i);
-                                } else if (logIndexTypeCode == clickhouse::Type::Code::UInt32) {
-                                    log.logIndex = block[4]->As<clickhouse::ColumnUInt32>()->At(i);
-                                } else if (logIndexTypeCode == clickhouse::Type::Code::Int64) {
-                                    log.logIndex = block[4]->As<clickhouse::ColumnInt64>()->At(i);
-                                } else {
-                                }
-
-                                if (block.GetColumnCount() > 5) {
-                                    auto nullable = block[5]->As<clickhouse::ColumnNullable>();
-                                    if (nullable && !nullable->IsNull(i)) {
-                                        auto nested = nullable->Nested()->As<clickhouse::ColumnString>();
-                                        if (nested) {
-                                            log.topic0 = nested->At(i);
-                                        }
-                                    }
-                                }
-
-                                if (block.GetColumnCount() > 6) {
-                                    auto nullable = block[6]->As<clickhouse::ColumnNullable>();
-                                    if (nullable && !nullable->IsNull(i)) {
-                                        auto nested = nullable->Nested()->As<clickhouse::ColumnString>();
-                                        if (nested) {
-                                            log.topic1 = nested->At(i);
-                                        }
-                                    }
-                                }
-
-                                if (block.GetColumnCount() > 7) {
-                                    auto nullable = block[7]->As<clickhouse::ColumnNullable>();
-                                    if (nullable && !nullable->IsNull(i)) {
-                                        auto nested = nullable->Nested()->As<clickhouse::ColumnString>();
-                                        if (nested) {
-                                            log.topic2 = nested->At(i);
-                                        }
-                                    }
-                                }
-
-                                if (block.GetColumnCount() > 8) {
-                                    auto nullable = block[8]->As<clickhouse::ColumnNullable>();
-                                    if (nullable && !nullable->IsNull(i)) {
-                                        auto nested = nullable->Nested()->As<clickhouse::ColumnString>();
-                                        if (nested) {
-                                            log.topic3 = nested->At(i);
-                                        }
-                                    }
-                                }
-                                
-                                pageResults.push_back(log);
-                                pageLogsCount++;
-                            } catch (const std::exception &e) {
-                                spdlog::error("Error processing row {}: {}", i, e.what());
-                            }
-                        }
-                    } catch (const std::exception &e) {
-                        spdlog::error("Error processing log row: {}", e.what());
-                    }
-                });
+                LogPage pageResults;
+                size_t pageLogsCount = fetchLogPage(*client, startBlock, endBlock, cursorBlock, cursorLogIndex,
+                                                    options.binary, pageResults);
 
                 totalProcessed += pageLogsCount;
-                
-                if (!pageResults.empty()) {
-                    callback(pageResults, pageNumber, totalProcessed);
-                }
-                
-                if (pageLogsCount < PAGE_SIZE) {
+
+                if (pageLogsCount < PAGE_SIZE || pageResults.empty()) {
+                    if (!pageResults.empty()) {
+                        callback(pageResults, pageNumber, totalProcessed);
+                    }
                     spdlog::info("Completed streaming {} total logs across {} pages", totalProcessed, pageNumber);
                     break;
                 }
-                
-                offset += PAGE_SIZE;
+
+                // Read the cursor before the callback, which may consume the page
+                cursorBlock = pageResults.back().blockNumber;
+                cursorLogIndex = pageResults.back().logIndex + 1;
+
+                callback(pageResults, pageNumber, totalProcessed);
                 pageNumber++;
             }
         } catch (const std::exception &e) {
-            std::string error_msg = e.what();
-            if (error_msg.find("OpenSSL error") != std::string::npos ||
-                error_msg.find("SSL") != std::string::npos ||
-                error_msg.find("certificate") != std::string::npos ||
-                error_msg.find("unexpected eof") != std::string::npos) {
-                spdlog::error("SSL Connection Error: {}", error_msg);
-                spdlog::error("Suggestions:");
-                spdlog::error("  - Verify ClickHouse Cloud connection parameters");
-                spdlog::error("  - Check if port 9440 is correct for native secure connections");
-                spdlog::error("  - Ensure your IP is whitelisted in ClickHouse Cloud");
-                spdlog::error("  - Try reducing the block range if the query is too large");
-            } else {
-                spdlog::error("Failed to stream logs: {}", error_msg);
-            }
+            logStreamError(e);
+            client_.getPool()->returnConnection(client);
+            throw;
         }
 
         client_.getPool()->returnConnection(client);
     }
 
-    std::map<std::string, ContractABI> ClickHouseEthereum::getBatchContractABI(const std::vector<std::string> &addresses) {
+    void ClickHouseEthereum::streamLogsSharded(uint64_t startBlock, uint64_t endBlock, PageCallback& callback,
+                                               const StreamOptions& options) {
+        const size_t PAGE_SIZE = queryConfig_.getPageSize();
+        const uint64_t shardBlocks = std::max<uint64_t>(options.shardBlocks, 1);
+
+        struct Shard {
+            uint64_t startBlock;
+            uint64_t endBlock;
+            std::deque<LogPage> pages;  // Ordered mode only
+            bool done = false;
+        };
+
+        std::vector<Shard> shards;
+        for (uint64_t block = startBlock; block <= endBlock; block += shardBlocks) {
+            Shard shard;
+            shard.startBlock = block;
+            shard.endBlock = endBlock - block < shardBlocks ? endBlock : block + shardBlocks - 1;
+            shards.push_back(std::move(shard));
+            if (shards.back().endBlock == endBlock) {
+                break;
+            }
+        }
+
+        const size_t numFetchers = std::min(options.shards, shards.size());
+        // Pages waiting for the callback, across all shards. Bounds memory when fetching
+        // outpaces the callback; the head shard may always hold one page so it never starves
+        const size_t maxBufferedPages = 2 * numFetchers;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::deque<LogPage> readyPages;  // Unordered mode
+        size_t nextShard = 0;
+        size_t headShard = 0;
+        size_t bufferedPages = 0;
+        size_t activeFetchers = numFetchers;
+        bool stopped = false;
+        bool failed = false;
+        std::exception_ptr error;  // First fetch failure, rethrown once the fetchers stopped
+
+        spdlog::info("Streaming blocks {} - {} as {} shards over {} connections ({})", startBlock, endBlock,
+                     shards.size(), numFetchers, options.ordered ? "ordered" : "unordered");
+
+        auto fetcher = [&]() {
+            while (true) {
+                size_t shardIndex;
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (stopped || nextShard >= shards.size()) {
+                        break;
+                    }
+                    shardIndex = nextShard++;
+                }
+
+                Shard& shard = shards[shardIndex];
+                uint64_t cursorBlock = shard.startBlock;
+                uint64_t cursorLogIndex = shard.startBlock == startBlock ? options.startLogIndex : 0;
+
+                try {
+                    while (true) {
+                        // Connections are only held while a query runs, so fetchers waiting for
+                        // buffer space never starve ABI lookups or inserts of a pooled connection
+                        LogPage pageResults;
+                        auto client = client_.getPool()->getConnection();
+                        size_t pageLogsCount;
+                        try {
+                            pageLogsCount = fetchLogPage(*client, shard.startBlock, shard.endBlock,
+                                                         cursorBlock, cursorLogIndex, options.binary, pageResults);
+                        } catch (...) {
+                            client_.getPool()->returnConnection(client);
+                            throw;
+                        }
+                        client_.getPool()->returnConnection(client);
+
+                        bool lastPage = pageLogsCount < PAGE_SIZE || pageResults.empty();
+                        if (!lastPage) {
+                            cursorBlock = pageResults.back().blockNumber;
+                            cursorLogIndex = pageResults.back().logIndex + 1;
+                        }
+
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition.wait(lock, [&] {
+                            return stopped || bufferedPages < maxBufferedPages ||
+                                   (options.ordered && shardIndex == headShard && shard.pages.empty());
+                        });
+                        if (stopped) {
+                            return;
+                        }
+
+                        if (!pageResults.empty()) {
+                            if (options.ordered) {
+                                shard.pages.push_back(std::move(pageResults));
+                            } else {
+                                readyPages.push_back(std::move(pageResults));
+                            }
+                            bufferedPages++;
+                        }
+                        if (lastPage) {
+                            shard.done = true;
+                        }
+                        condition.notify_all();
+
+                        if (lastPage) {
+                            break;
+                        }
+                    }
+                } catch (const std::exception &e) {
+                    logStreamError(e);
+                    std::lock_guard<std::mutex> lock(mutex);
+                    stopped = true;
+                    if (!failed) {
+                        error = std::current_exception();
+                    }
+                    failed = true;
+                    condition.notify_all();
+                    break;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            activeFetchers--;
+            condition.notify_all();
+        };
+
+        std::vector<std::thread> fetchers;
+        for (size_t i = 0; i < numFetchers; ++i) {
+            fetchers.emplace_back(fetcher);
+        }
+
+        size_t totalProcessed = 0;
+        size_t pageNumber = 0;
+
+        auto stopFetchers = [&]() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopped = true;
+                condition.notify_all();
+            }
+            for (auto &thread : fetchers) {
+                thread.join();
+            }
+        };
+
+        try {
+            while (true) {
+                LogPage pageResults;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    if (options.ordered) {
+                        condition.wait(lock, [&] {
+                            return failed || headShard >= shards.size() ||
+                                   !shards[headShard].pages.empty() || shards[headShard].done;
+                        });
+                        if (failed || headShard >= shards.size()) {
+                            break;
+                        }
+
+                        Shard& head = shards[headShard];
+                        if (head.pages.empty()) {
+                            headShard++;
+                            condition.notify_all();
+                            continue;
+                        }
+                        pageResults = std::move(head.pages.front());
+                        head.pages.pop_front();
+                    } else {
+                        condition.wait(lock, [&] {
+                            return failed || !readyPages.empty() || activeFetchers == 0;
+                        });
+                        if (failed || readyPages.empty()) {
+                            break;
+                        }
+                        pageResults = std::move(readyPages.front());
+                        readyPages.pop_front();
+                    }
+                    bufferedPages--;
+                    condition.notify_all();
+                }
+
+                pageNumber++;
+                totalProcessed += pageResults.size();
+                callback(pageResults, pageNumber, totalProcessed);
+            }
+        } catch (...) {
+            stopFetchers();
+            throw;
+        }
+
+        stopFetchers();
+
+        if (failed) {
+            spdlog::error("Streaming stopped after {} logs across {} pages", totalProcessed, pageNumber);
+            std::rethrow_exception(error);
+        }
+        spdlog::info("Completed streaming {} total logs across {} pages", totalProcessed, pageNumber);
+    }
+
+    size_t ClickHouseEthereum::fetchLogPage(clickhouse::Client& client, uint64_t startBlock, uint64_t endBlock,
+                                            uint64_t cursorBlock, uint64_t cursorLogIndex, bool binary,
+                                            LogPage& pageResults) {
+        // Use configurable query
+        std::string queryStr = queryConfig_.formatLogStreamQuery(startBlock, endBlock, queryConfig_.getPageSize(),
+                                                                 cursorBlock, cursorLogIndex, binary);
+
+        size_t pageLogsCount = 0;
+        pageResults.reserve(queryConfig_.getPageSize());
+
+        // A block that cannot be read fails the page: skipping it would end the stream early
+        // and let the checkpoint mark the logs it held as done
+        try {
+            client.Select(queryStr, [&pageResults, &pageLogsCount, binary](const clickhouse::Block &block) {
+                pageResults.append(block, binary);
+                pageLogsCount += block.GetRowCount();
+            });
+        } catch (const std::exception &) {
+            // The aborted query leaves unread packets behind, so reconnect before the
+            // connection goes back to the pool
+            try {
+                client.ResetConnection();
+            } catch (const std::exception &reset) {
+                spdlog::warn("Failed to reset ClickHouse connection: {}", reset.what());
+            }
+            throw;
+        }
+
+        return pageLogsCount;
+    }
+
+    void ClickHouseEthereum::logStreamError(const std::exception& e) {
+        std::string error_msg = e.what();
+        if (error_msg.find("OpenSSL error") != std::string::npos ||
+            error_msg.find("SSL") != std::string::npos ||
+            error_msg.find("certificate") != std::string::npos ||
+            error_msg.find("unexpected eof") != std::string::npos) {
+            spdlog::error("SSL Connection Error: {}", error_msg);
+            spdlog::error("Suggestions:");
+            spdlog::error("  - Verify ClickHouse Cloud connection parameters");
+            spdlog::error("  - Check if port 9440 is correct for native secure connections");
+            spdlog::error("  - Ensure your IP is whitelisted in ClickHouse Cloud");
+            spdlog::error("  - Try reducing the block range if the query is too large");
+        } else {
+            spdlog::error("Failed to stream logs: {}", error_msg);
+        }
+    }
+
+    std::map<std::string, ContractABI> ClickHouseEthereum::getBatchContractABI(const std::vector<std::string> &addresses,
+                                                                              bool *fetched) {
         std::map<std::string, ContractABI> contractMap;
+        if (fetched) {
+            *fetched = true;
+        }
 
         if (addresses.empty()) {
             return contractMap;
@@ -190,6 +358,9 @@ namespace decode_clickhouse {
             });
         } catch (const std::exception &e) {
             spdlog::error("Failed to batch fetch contract ABIs: {}", e.what());
+            if (fetched) {
+                *fetched = false;
+            }
         }
 
         client_.getPool()->returnConnection(client);
@@ -201,30 +372,74 @@ namespace decode_clickhouse {
             return true;
         }
 
-        auto client = client_.getPool()->getConnection();
+        std::lock_guard<std::mutex> lock(insertMutex_);
 
         try {
-            // Execute configurable ClickHouse settings
-            for (const auto& setting : queryConfig_.getAsyncInsertSettings()) {
-                client->Execute(setting);
-            }
-            
-            // Execute an INSERT statement for each log record
-            for (const auto& log : decodedLogs) {
-                // Format the insert query with the log record
-                std::string insertQuery = queryConfig_.formatDecodedLogsInsertQuery(log);
-                
-                // Execute the insert query
-                client->Execute(insertQuery);
+            if (!insertConnection_) {
+                insertConnection_ = client_.getPool()->createConnection(client_.getConfig().getInsertCompression());
+                if (!insertConnection_) {
+                    throw std::runtime_error("Could not open insert connection");
+                }
+
+                // Session settings, they stay in effect for every insert on this connection
+                for (const auto& setting : queryConfig_.getAsyncInsertSettings()) {
+                    insertConnection_->Execute(setting);
+                }
+                if (waitForAsyncInsert_) {
+                    insertConnection_->Execute("SET wait_for_async_insert = 1");
+                }
             }
 
-            client_.getPool()->returnConnection(client);
+            insertConnection_->Insert(queryConfig_.getDecodedLogsInsertTable(), buildDecodedLogsBlock(decodedLogs));
             return true;
         } catch (const std::exception &e) {
             spdlog::error("Failed to insert decoded logs: {}", e.what());
-            client_.getPool()->returnConnection(client);
+
+            // The connection may be broken; the next batch starts over on a fresh one
+            insertConnection_.reset();
             return false;
         }
     }
 
+    clickhouse::Block ClickHouseEthereum::buildDecodedLogsBlock(
+            const std::vector<ethereum_decoder::DecodedLogRecord> &decodedLogs) const {
+        using Record = ethereum_decoder::DecodedLogRecord;
+        static const std::map<std::string, std::string Record::*> stringFields = {
+            {"transactionHash", &Record::transactionHash},
+            {"contractAddress", &Record::contractAddress},
+            {"eventName", &Record::eventName},
+            {"eventSignature", &Record::eventSignature},
+            {"signature", &Record::signature},
+            {"args", &Record::args}
+        };
+
+        clickhouse::Block block;
+        for (const auto& column : queryConfig_.getDecodedLogsInsertColumns()) {
+            if (column.field == "logIndex") {
+                auto values = std::make_shared<clickhouse::ColumnUInt32>();
+                values->Reserve(decodedLogs.size());
+                for (const auto& log : decodedLogs) {
+                    values->Append(log.logIndex);
+                }
+                block.AppendColumn(column.name, values);
+            } else if (column.field == "blockNumber") {
+                auto values = std::make_shared<clickhouse::ColumnUInt64>();
+                values->Reserve(decodedLogs.size());
+                for (const auto& log : decodedLogs) {
+                    values->Append(log.blockNumber);
+                }
+                block.AppendColumn(column.name, values);
+            } else {
+                std::string Record::* field = stringFields.at(column.field);
+                auto values = std::make_shared<clickhouse::ColumnString>();
+                values->Reserve(decodedLogs.size());
+                for (const auto& log : decodedLogs) {
+                    values->Append(log.*field);
+                }
+                block.AppendColumn(column.name, values);
+            }
+        }
+        return block;
+    }
+
 } // namespace decode_clickhouse
\ No newline at end of file
@@ -1,9 +1,9 @@
 #include "include/clickhouse/clickhouse_query_config.h"
-#include "../../../ethereum_decoder/include/ethereum_decoder.h"
 #include <fstream>
 #include <sstream>
 #include <stdexcept>
 #include <algorithm>
+#include <cctype>
 #include <spdlog/spdlog.h>
 #include <nlohmann/json.hpp>
 
@@ -14,6 +14,43 @@ ClickHouseQueryConfig::ClickHouseQueryConfig()
     loadDefaults();
 }
 
+namespace {
+
+    // DecodedLogRecord fields the insert template may reference as {field}
+    const std::vector<std::string> INSERT_FIELDS = {
+        "transactionHash", "blockNumber", "logIndex", "contractAddress",
+        "eventName", "eventSignature", "signature", "args"
+    };
+
+    std::string trim(const std::string& str) {
+        size_t start = str.find_first_not_of(" \t\r\n");
+        if (start == std::string::npos) {
+            return "";
+        }
+        size_t end = str.find_last_not_of(" \t\r\n");
+        return str.substr(start, end - start + 1);
+    }
+
+    // Comma separated items of the parenthesized list starting at or after pos
+    std::vector<std::string> parseList(const std::string& sql, size_t pos, size_t& endPos) {
+        size_t open = sql.find('(', pos);
+        size_t close = open == std::string::npos ? std::string::npos : sql.find(')', open);
+        if (close == std::string::npos) {
+            throw std::runtime_error("Expected a parenthesized list in decoded logs insert query");
+        }
+
+        std::vector<std::string> items;
+        std::stringstream ss(sql.substr(open + 1, close - open - 1));
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            items.push_back(trim(item));
+        }
+        endPos = close + 1;
+        return items;
+    }
+
+} // anonymous namespace
+
 void ClickHouseQueryConfig::loadFromFiles(const std::string& configDir) {
     try {
         // Load configuration from JSON file
@@ -39,6 +76,22 @@ void ClickHouseQueryConfig::loadFromFiles(const std::string& configDir) {
         logStreamQuery_ = loadFileContent(configDir + "log_stream.sql");
         contractABIQuery_ = loadFileContent(configDir + "contract_abi.sql");
         decodedLogsInsertQuery_ = loadFileContent(configDir + "decoded_logs_insert.sql");
+        parseDecodedLogsInsertQuery();
+
+        // Optional, configurations predating it keep the built-in binary query
+        try {
+            logStreamBinaryQuery_ = loadFileContent(configDir + "log_stream_binary.sql");
+        } catch (const std::exception& e) {
+            spdlog::debug("{}, using the default binary log stream query", e.what());
+        }
+
+        // An OFFSET-style template would return the first page forever
+        for (const std::string* query : {&logStreamQuery_, &logStreamBinaryQuery_}) {
+            if (query->find("{CURSOR_BLOCK}") == std::string::npos ||
+                query->find("{CURSOR_LOG_INDEX}") == std::string::npos) {
+                throw std::runtime_error("Log stream queries must use the {CURSOR_BLOCK} and {CURSOR_LOG_INDEX} placeholders");
+            }
+        }
         
         // Load ClickHouse settings
         std::string settingsContent = loadFileContent(configDir + "clickhouse_settings.sql");
@@ -64,15 +117,16 @@ void ClickHouseQueryConfig::loadDefaults() {
     initializeDefaultSettings();
 }
 
-std::string ClickHouseQueryConfig::formatLogStreamQuery(uint64_t startBlock, uint64_t endBlock, 
-                                                       size_t pageSize, size_t offset) const {
-    std::string query = logStreamQuery_;
+std::string ClickHouseQueryConfig::formatLogStreamQuery(uint64_t startBlock, uint64_t endBlock, size_t pageSize,
+                                                       uint64_t cursorBlock, uint64_t cursorLogIndex, bool binary) const {
+    std::string query = binary ? logStreamBinaryQuery_ : logStreamQuery_;
     
     // Replace placeholders
     std::string startStr = std::to_string(startBlock);
     std::string endStr = std::to_string(endBlock);
     std::string pageSizeStr = std::to_string(pageSize);
-    std::string offsetStr = std::to_string(offset);
+    std::string cursorBlockStr = std::to_string(cursorBlock);
+    std::string cursorLogIndexStr = std::to_string(cursorLogIndex);
     
     size_t pos;
     while ((pos = query.find("{START_BLOCK}")) != std::string::npos) {
@@ -84,8 +138,11 @@ std::string ClickHouseQueryConfig::formatLogStreamQuery(uint64_t startBlock, uin
     while ((pos = query.find("{PAGE_SIZE}")) != std::string::npos) {
         query.replace(pos, 11, pageSizeStr);
     }
-    while ((pos = query.find("{OFFSET}")) != std::string::npos) {
-        query.replace(pos, 8, offsetStr);
+    while ((pos = query.find("{CURSOR_BLOCK}")) != std::string::npos) {
+        query.replace(pos, 14, cursorBlockStr);
+    }
+    while ((pos = query.find("{CURSOR_LOG_INDEX}")) != std::string::npos) {
+        query.replace(pos, 18, cursorLogIndexStr);
     }
     
     return query;
@@ -102,55 +159,28 @@ std::string ClickHouseQueryConfig::formatContractABIQuery(const std::string& add
     return query;
 }
 
-std::string ClickHouseQueryConfig::formatDecodedLogsInsertQuery(const ethereum_decoder::DecodedLogRecord& log) const {
-    std::string query = decodedLogsInsertQuery_;
-    
-    // Helper function to escape single quotes in strings
-    auto escapeString = [](const std::string& str) {
-        std::string escaped = str;
-        size_t pos = 0;
-        while ((pos = escaped.find("'", pos)) != std::string::npos) {
-            escaped.replace(pos, 1, "''");
-            pos += 2;
-        }
-        return escaped;
-    };
-    
-    // Replace placeholders with actual values
-    size_t pos;
-    while ((pos = query.find("{transactionHash}")) != std::string::npos) {
-        query.replace(pos, 17, escapeString(log.transactionHash));
-    }
-    while ((pos = query.find("{logIndex}")) != std::string::npos) {
-        query.replace(pos, 10, std::to_string(log.logIndex));
-    }
-    while ((pos = query.find("{contractAddress}")) != std::string::npos) {
-        query.replace(pos, 17, escapeString(log.contractAddress));
-    }
-    while ((pos = query.find("{eventName}")) != std::string::npos) {
-        query.replace(pos, 11, escapeString(log.eventName));
-    }
-    while ((pos = query.find("{eventSignature}")) != std::string::npos) {
-        query.replace(pos, 16, escapeString(log.eventSignature));
-    }
-    while ((pos = query.find("{signature}")) != std::string::npos) {
-        query.replace(pos, 11, escapeString(log.signature));
-    }
-    while ((pos = query.find("{args}")) != std::string::npos) {
-        query.replace(pos, 6, escapeString(log.args));
-    }
-    
-    return query;
-}
-
 void ClickHouseQueryConfig::initializeDefaultQueries() {
     logStreamQuery_ = R"(SELECT transactionHash, blockNumber, address, data, logIndex,
        topic0, topic1, topic2, topic3
 FROM logs
-WHERE blockNumber >= {START_BLOCK} AND blockNumber <= {END_BLOCK}
+WHERE blockNumber >= {CURSOR_BLOCK} AND blockNumber <= {END_BLOCK}
+  AND (blockNumber > {CURSOR_BLOCK} OR logIndex >= {CURSOR_LOG_INDEX})
+  AND removed = 0
+ORDER BY blockNumber, logIndex
+LIMIT {PAGE_SIZE})";
+
+    logStreamBinaryQuery_ = R"(SELECT transactionHash, blockNumber, address,
+       unhex(substring(data, 3)) AS raw_data, logIndex,
+       toFixedString(unhex(substring(nullIf(topic0, ''), 3)), 32) AS raw_topic0,
+       toFixedString(unhex(substring(nullIf(topic1, ''), 3)), 32) AS raw_topic1,
+       toFixedString(unhex(substring(nullIf(topic2, ''), 3)), 32) AS raw_topic2,
+       toFixedString(unhex(substring(nullIf(topic3, ''), 3)), 32) AS raw_topic3
+FROM logs
+WHERE blockNumber >= {CURSOR_BLOCK} AND blockNumber <= {END_BLOCK}
+  AND (blockNumber > {CURSOR_BLOCK} OR logIndex >= {CURSOR_LOG_INDEX})
   AND removed = 0
 ORDER BY blockNumber, logIndex
-LIMIT {PAGE_SIZE} OFFSET {OFFSET})";
+LIMIT {PAGE_SIZE})";
 
     contractABIQuery_ = R"(SELECT ADDRESS, NAME, ABI, IMPLEMENTATION_ADDRESS
 FROM decoded_contracts
@@ -166,6 +196,63 @@ WHERE (ADDRESS IN ({ADDRESS_LIST}) OR IMPLEMENTATION_ADDRESS IN ({ADDRESS_LIST})
     signature,
     args
 ) VALUES ('{transactionHash}', {logIndex}, '{contractAddress}', '{eventName}', '{eventSignature}', '{signature}', '{args}'))";
+    parseDecodedLogsInsertQuery();
+}
+
+void ClickHouseQueryConfig::parseDecodedLogsInsertQuery() {
+    // Drop comment lines, they may mention table names and parentheses
+    std::string sql;
+    std::stringstream lines(decodedLogsInsertQuery_);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (trim(line).rfind("--", 0) != 0) {
+            sql += line + "\n";
+        }
+    }
+
+    std::string upper = sql;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+
+    size_t insertPos = upper.find("INSERT INTO");
+    size_t valuesPos = upper.find("VALUES");
+    if (insertPos == std::string::npos || valuesPos == std::string::npos) {
+        throw std::runtime_error("Decoded logs insert query must be INSERT INTO <table> (<columns>) VALUES (<fields>)");
+    }
+
+    size_t tableStart = sql.find_first_not_of(" \t\r\n", insertPos + 11);
+    size_t tableEnd = sql.find_first_of(" \t\r\n(", tableStart);
+    std::string table = sql.substr(tableStart, tableEnd - tableStart);
+
+    size_t endPos = 0;
+    std::vector<std::string> columns = parseList(sql, tableEnd, endPos);
+    if (endPos > valuesPos) {
+        throw std::runtime_error("Decoded logs insert query must list its columns before VALUES");
+    }
+    std::vector<std::string> values = parseList(sql, valuesPos, endPos);
+    if (table.empty() || columns.size() != values.size()) {
+        throw std::runtime_error("Decoded logs insert query needs one {field} value per column");
+    }
+
+    // Values are placeholders only; the rows are sent as native columns, not as SQL text
+    std::vector<InsertColumn> insertColumns;
+    for (size_t i = 0; i < columns.size(); ++i) {
+        std::string value = values[i];
+        if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'') {
+            value = value.substr(1, value.size() - 2);
+        }
+        if (value.size() < 3 || value.front() != '{' || value.back() != '}') {
+            throw std::runtime_error("Unsupported value in decoded logs insert query: " + values[i]);
+        }
+
+        std::string field = value.substr(1, value.size() - 2);
+        if (std::find(INSERT_FIELDS.begin(), INSERT_FIELDS.end(), field) == INSERT_FIELDS.end()) {
+            throw std::runtime_error("Unknown field in decoded logs insert query: " + value);
+        }
+        insertColumns.push_back({columns[i], field});
+    }
+
+    decodedLogsInsertTable_ = table;
+    decodedLogsInsertColumns_ = std::move(insertColumns);
 }
 
 void ClickHouseQueryConfig::initializeDefaultSettings() {
@@ -0,0 +1,194 @@
+#include "include/clickhouse/contract_abi_cache.h"
+#include "../../../ethereum_decoder/include/decoding/abi_parser.h"
+#include "../../../ethereum_decoder/include/decoding/signature_registry.h"
+#include <spdlog/spdlog.h>
+#include <chrono>
+#include <filesystem>
+#include <iterator>
+
+namespace decode_clickhouse {
+
+ContractABICache::ContractABICache(size_t capacity, const std::string& snapshotPath)
+    : capacity_(capacity), snapshotPath_(snapshotPath) {
+    if (snapshotPath_.empty() || !std::filesystem::exists(snapshotPath_)) {
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    snapshot_ = ethereum_decoder::ABISnapshot::open(snapshotPath_);
+    auto elapsed = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    spdlog::info("Loaded ABI snapshot {} with {} contracts in {:.2f} ms", snapshotPath_, snapshot_->size(), elapsed);
+}
+
+std::map<std::string, ContractABICache::DecoderPtr> ContractABICache::resolve(const std::vector<std::string>& addresses,
+                                                                               ClickHouseEthereum& ethereum) {
+    std::map<std::string, DecoderPtr> decoders;
+    std::vector<std::string> missing;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& address : addresses) {
+            auto it = index_.find(address);
+            if (it == index_.end()) {
+                missing.push_back(address);
+                continue;
+            }
+
+            hits_++;
+            entries_.splice(entries_.begin(), entries_, it->second);
+            if (it->second->decoder) {
+                decoders[address] = it->second->decoder;
+            }
+        }
+        misses_ += missing.size();
+    }
+
+    if (missing.empty()) {
+        return decoders;
+    }
+
+    // Load outside the lock so other callers are not blocked on disk or ClickHouse
+    std::vector<std::pair<std::string, DecoderPtr>> parsed;
+    parsed.reserve(missing.size());
+
+    std::vector<std::string> unknown;
+    for (const auto& address : missing) {
+        std::unique_ptr<ethereum_decoder::ABI> abi;
+        if (snapshot_) {
+            try {
+                abi = snapshot_->load(address);
+            } catch (const std::exception& e) {
+                spdlog::error("Failed to load ABI for contract {} from snapshot: {}", address, e.what());
+            }
+        }
+
+        if (abi) {
+            parsed.emplace_back(address, createDecoder(std::move(abi)));
+        } else {
+            unknown.push_back(address);
+        }
+    }
+    if (snapshot_) {
+        spdlog::debug("Loaded {} out of {} uncached contracts from ABI snapshot", parsed.size(), missing.size());
+    }
+
+    std::vector<ContractABI> fetchedABIs;
+    if (!unknown.empty()) {
+        bool fetched = true;
+        auto contractABIs = ethereum.getBatchContractABI(unknown, &fetched);
+        spdlog::debug("Fetched ABIs for {} out of {} uncached contracts", contractABIs.size(), unknown.size());
+
+        for (const auto& address : unknown) {
+            auto abiIt = contractABIs.find(address);
+            if (abiIt == contractABIs.end()) {
+                // A failed query says nothing about the contract, so only cache confirmed misses
+                if (fetched) {
+                    parsed.emplace_back(address, nullptr);
+                }
+                continue;
+            }
+
+            DecoderPtr decoder = parseABI(address, abiIt->second.abi);
+            if (decoder && !snapshotPath_.empty()) {
+                ContractABI contract = abiIt->second;
+                contract.address = address;
+                fetchedABIs.push_back(std::move(contract));
+            }
+            parsed.emplace_back(address, std::move(decoder));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::move(fetchedABIs.begin(), fetchedABIs.end(), std::back_inserter(fetchedABIs_));
+    for (auto& [address, decoder] : parsed) {
+        if (decoder) {
+            decoders[address] = decoder;
+        }
+        insert(address, std::move(decoder));
+    }
+
+    return decoders;
+}
+
+size_t ContractABICache::saveSnapshot() {
+    std::vector<ContractABI> fetchedABIs;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        fetchedABIs.swap(fetchedABIs_);
+    }
+    if (snapshotPath_.empty() || fetchedABIs.empty()) {
+        return 0;
+    }
+
+    ethereum_decoder::ABISnapshotWriter writer;
+    ethereum_decoder::ABIParser abiParser;
+    for (const auto& contract : fetchedABIs) {
+        try {
+            writer.add(contract.address, contract.name, *abiParser.parseFromString(contract.abi));
+        } catch (const std::exception& e) {
+            spdlog::warn("Not adding contract {} to ABI snapshot: {}", contract.address, e.what());
+        }
+    }
+    size_t added = writer.size();
+
+    // ABIs fetched in this run are newer than the snapshot, so they win over existing entries
+    if (snapshot_) {
+        writer.addAll(*snapshot_);
+    }
+    writer.write(snapshotPath_);
+
+    spdlog::info("Updated ABI snapshot {}: {} new contracts, {} total", snapshotPath_, added, writer.size());
+    return added;
+}
+
+size_t ContractABICache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+size_t ContractABICache::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+size_t ContractABICache::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+void ContractABICache::insert(const std::string& address, DecoderPtr decoder) {
+    auto it = index_.find(address);
+    if (it != index_.end()) {
+        it->second->decoder = std::move(decoder);
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    entries_.push_front({address, std::move(decoder)});
+    index_[address] = entries_.begin();
+
+    // Decoders handed out earlier stay alive through their shared_ptr
+    while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().address);
+        entries_.pop_back();
+    }
+}
+
+ContractABICache::DecoderPtr ContractABICache::createDecoder(std::unique_ptr<ethereum_decoder::ABI> abi) {
+    auto& registry = ethereum_decoder::SignatureRegistry::global();
+    registry.registerABI(*abi);
+    return std::make_shared<ethereum_decoder::EthereumDecoder>(std::move(abi), &registry);
+}
+
+ContractABICache::DecoderPtr ContractABICache::parseABI(const std::string& address, const std::string& abiJson) {
+    try {
+        ethereum_decoder::ABIParser abiParser;
+        return createDecoder(abiParser.parseFromString(abiJson));
+    } catch (const std::exception& e) {
+        // Cached as a miss so a broken ABI is not re-parsed on every page
+        spdlog::error("Failed to parse ABI for contract {}: {}", address, e.what());
+        return nullptr;
+    }
+}
+
+} // namespace decode_clickhouse
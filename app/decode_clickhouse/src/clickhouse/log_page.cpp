@@ -0,0 +1,112 @@
+#include "include/clickhouse/log_page.h"
+#include <clickhouse/columns/nullable.h>
+#include <stdexcept>
+
+namespace decode_clickhouse {
+
+namespace {
+
+// Integer column of any width the log stream query may return
+class UIntReader {
+public:
+    UIntReader(const clickhouse::Block& block, size_t index)
+        : uint64_(block[index]->As<clickhouse::ColumnUInt64>()),
+          uint32_(block[index]->As<clickhouse::ColumnUInt32>()),
+          int64_(block[index]->As<clickhouse::ColumnInt64>()) {
+        if (!uint64_ && !uint32_ && !int64_) {
+            throw std::runtime_error("Unsupported type for integer column " + block.GetColumnName(index));
+        }
+    }
+
+    uint64_t operator()(size_t row) const {
+        if (uint64_) {
+            return uint64_->At(row);
+        }
+        if (uint32_) {
+            return uint32_->At(row);
+        }
+        return static_cast<uint64_t>(int64_->At(row));
+    }
+
+private:
+    std::shared_ptr<clickhouse::ColumnUInt64> uint64_;
+    std::shared_ptr<clickhouse::ColumnUInt32> uint32_;
+    std::shared_ptr<clickhouse::ColumnInt64> int64_;
+};
+
+// String or FixedString column, also when wrapped in Nullable; NULL reads as empty.
+// Without a column every row reads as empty, for topics the query does not return
+class StringReader {
+public:
+    StringReader() = default;
+
+    StringReader(const clickhouse::Block& block, size_t index) {
+        clickhouse::ColumnRef column = block[index];
+        if (auto nullable = column->As<clickhouse::ColumnNullable>()) {
+            nullable_ = nullable;
+            column = nullable->Nested();
+        }
+        text_ = column->As<clickhouse::ColumnString>();
+        fixed_ = column->As<clickhouse::ColumnFixedString>();
+        if (!text_ && !fixed_) {
+            throw std::runtime_error("Unsupported type for string column " + block.GetColumnName(index));
+        }
+    }
+
+    std::string_view operator()(size_t row) const {
+        if (nullable_ && nullable_->IsNull(row)) {
+            return std::string_view();
+        }
+        if (text_) {
+            return text_->At(row);
+        }
+        if (fixed_) {
+            return fixed_->At(row);
+        }
+        return std::string_view();
+    }
+
+private:
+    std::shared_ptr<clickhouse::ColumnNullable> nullable_;
+    std::shared_ptr<clickhouse::ColumnString> text_;
+    std::shared_ptr<clickhouse::ColumnFixedString> fixed_;
+};
+
+} // anonymous namespace
+
+void LogPage::append(const clickhouse::Block& block, bool binary) {
+    const size_t rows = block.GetRowCount();
+    if (rows == 0) {
+        return;
+    }
+
+    StringReader transactionHash(block, 0);
+    UIntReader blockNumber(block, 1);
+    StringReader address(block, 2);
+    StringReader data(block, 3);
+    UIntReader logIndex(block, 4);
+
+    // Hex text as String, or raw bytes as FixedString(32) in binary mode
+    StringReader topics[4];
+    for (size_t i = 0; i < 4 && 5 + i < block.GetColumnCount(); ++i) {
+        topics[i] = StringReader(block, 5 + i);
+    }
+
+    blocks_.push_back(block);
+    for (size_t row = 0; row < rows; ++row) {
+        LogRecord log;
+        log.transactionHash = transactionHash(row);
+        log.blockNumber = blockNumber(row);
+        log.address = address(row);
+        log.data = data(row);
+        log.logIndex = logIndex(row);
+        log.topic0 = topics[0](row);
+        log.topic1 = topics[1](row);
+        log.topic2 = topics[2](row);
+        log.topic3 = topics[3](row);
+        log.binary = binary;
+        logs_.push_back(log);
+    }
+}
+
+} // namespace decode_clickhouse
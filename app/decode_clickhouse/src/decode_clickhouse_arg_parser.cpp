@@ -5,6 +5,39 @@
 
 namespace decode_clickhouse {
 
+namespace {
+
+void validateCompression(const std::string& method) {
+    if (method != "none" && method != "lz4" && method != "zstd") {
+        throw std::runtime_error("Compression must be none, lz4 or zstd: " + method);
+    }
+}
+
+void validateParquetCompression(const std::string& codec) {
+    if (codec != "none" && codec != "snappy" && codec != "gzip" && codec != "lz4" && codec != "zstd") {
+        throw std::runtime_error("Parquet compression must be none, snappy, gzip, lz4 or zstd: " + codec);
+    }
+}
+
+// Comma-separated column names; "all" selects every column and "none" no column
+void parseColumnList(const std::string& value, std::vector<std::string>& columns, bool& allColumns) {
+    columns.clear();
+    allColumns = value == "all";
+    if (allColumns || value == "none") {
+        return;
+    }
+
+    std::stringstream stream(value);
+    std::string column;
+    while (std::getline(stream, column, ',')) {
+        if (!column.empty()) {
+            columns.push_back(column);
+        }
+    }
+}
+
+} // anonymous namespace
+
 ClickHouseArgs DecodeClickhouseArgParser::parse(int argc, char *argv[]) {
     ClickHouseArgs args;
 
@@ -33,6 +66,12 @@ ClickHouseArgs DecodeClickhouseArgParser::parse(int argc, char *argv[]) {
             args.config.database = argv[++i];
         } else if (arg == "--port" && i + 1 < argc) {
             args.config.port = std::stoi(argv[++i]);
+        } else if (arg == "--compression" && i + 1 < argc) {
+            args.config.compression = argv[++i];
+            validateCompression(args.config.compression);
+        } else if (arg == "--insert-compression" && i + 1 < argc) {
+            args.config.insertCompression = argv[++i];
+            validateCompression(args.config.insertCompression);
         } else if (arg == "--blockrange" && i + 1 < argc) {
             args.blockRange = parseBlockRange(argv[++i]);
         } else if (arg == "--workers" && i + 1 < argc) {
@@ -63,6 +102,74 @@ ClickHouseArgs DecodeClickhouseArgParser::parse(int argc, char *argv[]) {
             if (args.logsPageSize < 100) {
                 throw std::runtime_error("Logs page size must be at least 100");
             }
+        } else if (arg == "--abi-cache-size" && i + 1 < argc) {
+            args.abiCacheSize = std::stoul(argv[++i]);
+            if (args.abiCacheSize < 1) {
+                throw std::runtime_error("ABI cache size must be at least 1");
+            }
+        } else if (arg == "--abi-snapshot" && i + 1 < argc) {
+            args.abiSnapshotPath = argv[++i];
+        } else if (arg == "--fetch-shards" && i + 1 < argc) {
+            args.fetchShards = std::stoul(argv[++i]);
+            if (args.fetchShards < 1) {
+                throw std::runtime_error("Number of fetch shards must be at least 1");
+            }
+        } else if (arg == "--shard-blocks" && i + 1 < argc) {
+            args.shardBlocks = std::stoull(argv[++i]);
+            if (args.shardBlocks < 1) {
+                throw std::runtime_error("Shard size must be at least 1 block");
+            }
+        } else if (arg == "--unordered") {
+            args.unorderedFetch = true;
+        } else if (arg == "--binary-logs") {
+            args.binaryLogs = true;
+        } else if (arg == "--write-batches-in-flight" && i + 1 < argc) {
+            args.writeBatchesInFlight = std::stoul(argv[++i]);
+        } else if (arg == "--checkpoint-file" && i + 1 < argc) {
+            args.checkpointFile = argv[++i];
+        } else if (arg == "--resume") {
+            args.resume = true;
+        } else if (arg == "--parquet-file-rows" && i + 1 < argc) {
+            args.parquet.fileRows = std::stoul(argv[++i]);
+            if (args.parquet.fileRows < 1) {
+                throw std::runtime_error("Parquet file rows must be at least 1");
+            }
+        } else if (arg == "--parquet-file-mb" && i + 1 < argc) {
+            args.parquet.fileBytes = std::stoul(argv[++i]) * 1024 * 1024;
+            if (args.parquet.fileBytes < 1) {
+                throw std::runtime_error("Parquet file size must be at least 1 MB");
+            }
+        } else if (arg == "--parquet-file-seconds" && i + 1 < argc) {
+            args.parquet.fileSeconds = std::stoul(argv[++i]);
+        } else if (arg == "--parquet-row-group-rows" && i + 1 < argc) {
+            args.parquet.rowGroupRows = std::stoul(argv[++i]);
+            if (args.parquet.rowGroupRows < 1) {
+                throw std::runtime_error("Parquet row group rows must be at least 1");
+            }
+        } else if (arg == "--json-compression" && i + 1 < argc) {
+            args.json.compression = argv[++i];
+            if (args.json.compression != "none" && args.json.compression != "gzip" &&
+                args.json.compression != "zstd") {
+                throw std::runtime_error("JSON compression must be none, gzip or zstd: " + args.json.compression);
+            }
+        } else if (arg == "--json-file-mb" && i + 1 < argc) {
+            args.json.fileBytes = std::stoul(argv[++i]) * 1024 * 1024;
+            if (args.json.fileBytes < 1) {
+                throw std::runtime_error("JSON file size must be at least 1 MB");
+            }
+        } else if (arg == "--json-file-seconds" && i + 1 < argc) {
+            args.json.fileSeconds = std::stoul(argv[++i]);
+        } else if (arg == "--parquet-per-event") {
+            args.parquet.perEvent = true;
+        } else if (arg == "--parquet-compression" && i + 1 < argc) {
+            args.parquet.compression = argv[++i];
+            validateParquetCompression(args.parquet.compression);
+        } else if (arg == "--parquet-compression-level" && i + 1 < argc) {
+            args.parquet.compressionLevel = std::stoi(argv[++i]);
+        } else if (arg == "--parquet-dictionary" && i + 1 < argc) {
+            parseColumnList(argv[++i], args.parquet.dictionaryColumns, args.parquet.dictionaryAllColumns);
+        } else if (arg == "--parquet-statistics" && i + 1 < argc) {
+            parseColumnList(argv[++i], args.parquet.statisticsColumns, args.parquet.statisticsAllColumns);
         } else {
             throw std::runtime_error("Unknown argument: " + arg);
         }
@@ -83,6 +190,13 @@ ClickHouseArgs DecodeClickhouseArgParser::parse(int argc, char *argv[]) {
     if (!args.blockRange.isValid()) {
         throw std::runtime_error("--blockrange is required and must be valid (e.g., 1-5000)");
     }
+    if (args.resume && args.unorderedFetch) {
+        throw std::runtime_error("--resume needs pages in block order and cannot be combined with --unordered");
+    }
+    if (args.parquet.compressionLevel &&
+        (args.parquet.compression == "none" || args.parquet.compression == "snappy")) {
+        throw std::runtime_error("--parquet-compression-level is not supported by " + args.parquet.compression);
+    }
 
     return args;
 }
@@ -98,13 +212,39 @@ void DecodeClickhouseArgParser::printUsage(const char *programName) const {
     std::cout << "  --blockrange <range>    Block range to decode (e.g., 1-5000)" << std::endl;
     std::cout << "\nOptional arguments:" << std::endl;
     std::cout << "  --workers <count>       Number of parallel workers (default: 8)" << std::endl;
+    std::cout << "  --compression <method>  Wire compression: none, lz4 or zstd (default: lz4)" << std::endl;
+    std::cout << "  --insert-compression <method>  Wire compression for decoded log inserts (default: same as --compression)" << std::endl;
     std::cout << "  --insert-decoded-logs   Enable insertion of decoded logs to database (disabled by default)" << std::endl;
     std::cout << "  --log-file <path>       Log file path (default: decode_clickhouse.log)" << std::endl;
     std::cout << "  --sql-config-dir <dir>  Directory containing SQL config files (default: use built-in queries)" << std::endl;
     std::cout << "  --output-dir <dir>      Output directory for decoded logs (default: decoded_logs)" << std::endl;
-    std::cout << "  --json                  Output in JSON format instead of Parquet (default: Parquet if available)" << std::endl;
+    std::cout << "  --json                  Output newline-delimited JSON instead of Parquet (default: Parquet if available)" << std::endl;
+    std::cout << "  --json-compression <codec>  JSON file compression: none, gzip or zstd (default: none)" << std::endl;
+    std::cout << "  --json-file-mb <n>      Size in MB at which a JSON file is closed (default: 256)" << std::endl;
+    std::cout << "  --json-file-seconds <n> Age at which a JSON file is closed, 0 = never (default: 300)" << std::endl;
     std::cout << "  --log-level <level>     Set log verbosity: debug, info, warning, error (default: info)" << std::endl;
     std::cout << "  --logs-page-size <size> Number of logs to fetch per page (default: 25000)" << std::endl;
+    std::cout << "  --abi-cache-size <n>    Number of contract ABIs cached across pages (default: 10000)" << std::endl;
+    std::cout << "  --abi-snapshot <path>   ABI snapshot file to load at startup and extend with fetched ABIs" << std::endl;
+    std::cout << "  --fetch-shards <n>      Block range shards fetched concurrently (default: 4, 1 = serial)" << std::endl;
+    std::cout << "  --shard-blocks <n>      Blocks per fetch shard (default: 1000)" << std::endl;
+    std::cout << "  --unordered             Decode pages as they arrive instead of in block order" << std::endl;
+    std::cout << "  --binary-logs           Fetch log data and topics as raw bytes instead of hex (log_stream_binary.sql)" << std::endl;
+    std::cout << "  --write-batches-in-flight <n>  Full batches each writer queues for background flushing (default: 2, 0 = synchronous)" << std::endl;
+    std::cout << "  --checkpoint-file <path>  File tracking each writer's written position (default: <output-dir>/.checkpoint.json)" << std::endl;
+    std::cout << "  --resume                Continue after the positions in the checkpoint file; logs past them that were" << std::endl;
+    std::cout << "                          already written are written again, deduplicate on (block_number, log_index)" << std::endl;
+    std::cout << "  --parquet-file-rows <n> Rows per Parquet file before starting a new one (default: 1000000)" << std::endl;
+    std::cout << "  --parquet-file-mb <n>   Size in MB at which a Parquet file is closed (default: 256)" << std::endl;
+    std::cout << "  --parquet-file-seconds <n>  Age at which a Parquet file is closed, 0 = never (default: 300)" << std::endl;
+    std::cout << "  --parquet-row-group-rows <n>  Rows per Parquet row group (default: 131072)" << std::endl;
+    std::cout << "  --parquet-per-event     One Parquet dataset per event with a typed column per parameter" << std::endl;
+    std::cout << "  --parquet-compression <codec>  Parquet codec: none, snappy, gzip, lz4 or zstd (default: zstd)" << std::endl;
+    std::cout << "  --parquet-compression-level <n>  Parquet codec level (default: codec default)" << std::endl;
+    std::cout << "  --parquet-dictionary <columns>  Dictionary-encoded columns, comma-separated, all or none" << std::endl;
+    std::cout << "                          (default: contract_address,event_name,event_signature,signature)" << std::endl;
+    std::cout << "  --parquet-statistics <columns>  Columns with min/max statistics, comma-separated, all or none" << std::endl;
+    std::cout << "                          (default: block_number,log_index,transaction_hash,contract_address)" << std::endl;
     std::cout << "  --help, -h              Show this help message" << std::endl;
     std::cout << "\nExample:" << std::endl;
     std::cout << "  " << programName << " \\" << std::endl;
@@ -1,5 +1,6 @@
 #include "include/log-writer/database_writer.h"
 #include <spdlog/spdlog.h>
+#include <algorithm>
 
 namespace decode_clickhouse {
 
@@ -9,11 +10,32 @@ DatabaseWriter::DatabaseWriter(size_t batchSize)
 }
 
 DatabaseWriter::~DatabaseWriter() {
+    shutdown();
+}
+
+void DatabaseWriter::shutdown() {
     try {
         flush();
     } catch (const std::exception& e) {
         spdlog::error("Error during DatabaseWriter destruction: {}", e.what());
     }
+
+    if (flushThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(flushMutex_);
+            stopping_ = true;
+        }
+        flushCondition_.notify_all();
+        flushThread_.join();
+    }
+}
+
+void DatabaseWriter::enableAsyncFlush(size_t maxInFlightBatches) {
+    if (maxInFlightBatches == 0 || flushThread_.joinable()) {
+        return;
+    }
+    maxInFlightBatches_ = maxInFlightBatches;
+    flushThread_ = std::thread(&DatabaseWriter::flushLoop, this);
 }
 
 void DatabaseWriter::write(const ethereum_decoder::DecodedLogRecord& record) {
@@ -21,30 +43,134 @@ void DatabaseWriter::write(const ethereum_decoder::DecodedLogRecord& record) {
     flushIfNeeded();
 }
 
+void DatabaseWriter::write(const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
+    for (const auto& record : records) {
+        pendingRecords_.push_back(record);
+        flushIfNeeded();
+    }
+}
+
 void DatabaseWriter::flush() {
-    if (pendingRecords_.empty()) {
+    if (isAsync()) {
+        if (!pendingRecords_.empty()) {
+            enqueuePending();
+        }
+        std::unique_lock<std::mutex> lock(flushMutex_);
+        flushCondition_.wait(lock, [this] { return inFlight_.empty() && !writing_; });
         return;
     }
 
-    spdlog::debug("Flushing {} pending records", pendingRecords_.size());
-    
-    if (writeBatch(pendingRecords_)) {
-        onBatchWritten(pendingRecords_.size());
-        totalWritten_ += pendingRecords_.size();
-    } else {
-        onBatchFailed(pendingRecords_.size(), "Batch write failed");
-        totalFailed_ += pendingRecords_.size();
+    if (pendingRecords_.empty()) {
+        return;
     }
-    
+
+    writeRecords(pendingRecords_);
     pendingRecords_.clear();
 }
 
 void DatabaseWriter::flushIfNeeded() {
     if (pendingRecords_.size() >= batchSize_) {
-        flush();
+        if (isAsync()) {
+            enqueuePending();
+        } else {
+            flush();
+        }
+    }
+}
+
+void DatabaseWriter::writeRecords(const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
+    spdlog::debug("Flushing {} pending records", records.size());
+
+    if (failed_) {
+        onBatchFailed(records.size(), "writer stopped after an earlier error");
+        totalFailed_ += records.size();
+        return;
+    }
+
+    if (writeBatch(records)) {
+        onBatchWritten(records.size());
+        totalWritten_ += records.size();
+        if (writtenCallback_ && !defersWrittenReport()) {
+            std::vector<LogPosition> positions;
+            positions.reserve(records.size());
+            for (const auto& record : records) {
+                positions.push_back({record.blockNumber, record.logIndex});
+            }
+            reportWritten(positions);
+        }
+    } else {
+        // A writer that failed in the middle of the batch may have stored part of it
+        size_t stored = std::min(failedBatchStored_, records.size());
+        failedBatchStored_ = 0;
+        totalWritten_ += stored;
+        onBatchFailed(records.size() - stored, "Batch write failed");
+        totalFailed_ += records.size() - stored;
     }
 }
 
+void DatabaseWriter::enqueuePending() {
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    flushCondition_.wait(lock, [this] { return inFlight_.size() < maxInFlightBatches_; });
+
+    // Continue in a buffer the flush thread is done with, so its capacity is reused
+    std::vector<ethereum_decoder::DecodedLogRecord> next;
+    if (!spareBuffers_.empty()) {
+        next = std::move(spareBuffers_.back());
+        spareBuffers_.pop_back();
+    } else {
+        next.reserve(batchSize_);
+    }
+
+    inFlight_.push_back(std::move(pendingRecords_));
+    pendingRecords_ = std::move(next);
+    flushCondition_.notify_all();
+}
+
+void DatabaseWriter::flushLoop() {
+    std::unique_lock<std::mutex> lock(flushMutex_);
+    while (true) {
+        flushCondition_.wait(lock, [this] { return stopping_ || !inFlight_.empty(); });
+        if (inFlight_.empty()) {
+            break;
+        }
+
+        auto records = std::move(inFlight_.front());
+        inFlight_.pop_front();
+        writing_ = true;
+        flushCondition_.notify_all();
+        lock.unlock();
+
+        try {
+            writeRecords(records);
+        } catch (const std::exception& e) {
+            onBatchFailed(records.size(), e.what());
+            totalFailed_ += records.size();
+        }
+        records.clear();
+
+        lock.lock();
+        if (spareBuffers_.size() < maxInFlightBatches_) {
+            spareBuffers_.push_back(std::move(records));
+        }
+        writing_ = false;
+        flushCondition_.notify_all();
+    }
+}
+
+void DatabaseWriter::reportWritten(const std::vector<LogPosition>& positions) {
+    if (writtenCallback_) {
+        writtenCallback_(positions);
+    }
+}
+
+void DatabaseWriter::fail(const std::string& error, size_t lostRecords, size_t storedRecords) {
+    spdlog::error("{} writer stopped, {} records written earlier are lost: {}", getName(), lostRecords, error);
+    failed_ = true;
+    totalWritten_ -= lostRecords;
+    totalFailed_ += lostRecords;
+    failedBatchStored_ = storedRecords;
+}
+
 void DatabaseWriter::onBatchWritten(size_t recordCount) {
     spdlog::info("Successfully wrote batch of {} records (total written: {})", 
                  recordCount, totalWritten_ + recordCount);
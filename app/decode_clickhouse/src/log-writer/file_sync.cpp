@@ -0,0 +1,35 @@
+#include "include/log-writer/file_sync.h"
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace decode_clickhouse {
+
+namespace {
+
+void syncPath(const std::string& path, int flags) {
+    int fd = ::open(path.c_str(), flags);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open " + path + " for sync: " + std::strerror(errno));
+    }
+    if (::fsync(fd) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Failed to sync " + path + ": " + std::strerror(error));
+    }
+    ::close(fd);
+}
+
+} // anonymous namespace
+
+void syncFile(const std::string& path) {
+    syncPath(path, O_RDONLY);
+}
+
+void syncDirectory(const std::string& path) {
+    syncPath(path.empty() ? "." : path, O_RDONLY | O_DIRECTORY);
+}
+
+} // namespace decode_clickhouse
@@ -0,0 +1,404 @@
+#include "include/ndjson/ndjson_database_writer.h"
+#include "include/log-writer/file_sync.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <zstd.h>
+
+namespace decode_clickhouse {
+
+namespace {
+
+// Serialized records collected before they go through the compressor
+constexpr size_t BUFFER_BYTES = 1024 * 1024;
+
+constexpr size_t COMPRESSED_CHUNK_BYTES = 128 * 1024;
+constexpr int ZSTD_LEVEL = 3;
+
+void appendJsonString(std::string& out, const std::string& value) {
+    static const char digits[] = "0123456789abcdef";
+
+    out += '"';
+    for (char c : value) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    out += "\\u00";
+                    out += digits[c >> 4];
+                    out += digits[c & 0x0f];
+                } else {
+                    out += c;
+                }
+        }
+    }
+    out += '"';
+}
+
+// Open files are named .blocks_<n><extension>.tmp
+bool isTemporaryFileName(const std::string& name) {
+    static const std::string prefix = ".blocks_";
+    static const std::string suffix = ".tmp";
+    return name.size() > prefix.size() + suffix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+           name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+} // anonymous namespace
+
+// An output file written through the configured compressor
+class NdjsonFile {
+public:
+    NdjsonFile(const std::string& path, const std::string& compression) : path_(path) {
+        if (compression == "gzip") {
+            // windowBits + 16 writes a gzip header and trailer instead of a zlib one
+            if (deflateInit2(&gzip_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+                throw std::runtime_error("Failed to initialize gzip compression");
+            }
+            gzipActive_ = true;
+        } else if (compression == "zstd") {
+            zstd_ = ZSTD_createCCtx();
+            if (!zstd_ || ZSTD_isError(ZSTD_CCtx_setParameter(zstd_, ZSTD_c_compressionLevel, ZSTD_LEVEL))) {
+                ZSTD_freeCCtx(zstd_);
+                throw std::runtime_error("Failed to initialize zstd compression");
+            }
+        } else if (compression != "none") {
+            throw std::runtime_error("Unsupported JSON compression: " + compression);
+        }
+
+        fd_ = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            release();
+            throw std::runtime_error("Failed to create file: " + path);
+        }
+        if (gzipActive_ || zstd_) {
+            chunk_.resize(COMPRESSED_CHUNK_BYTES);
+        }
+    }
+
+    ~NdjsonFile() {
+        release();
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    NdjsonFile(const NdjsonFile&) = delete;
+    NdjsonFile& operator=(const NdjsonFile&) = delete;
+
+    void write(const char* data, size_t size) {
+        if (gzipActive_) {
+            deflateChunks(data, size, Z_NO_FLUSH);
+        } else if (zstd_) {
+            compressChunks(data, size, ZSTD_e_continue);
+        } else {
+            writeOut(data, size);
+        }
+    }
+
+    // Write the compressor's trailer and close the file
+    void finish() {
+        if (gzipActive_) {
+            deflateChunks(nullptr, 0, Z_FINISH);
+        } else if (zstd_) {
+            compressChunks(nullptr, 0, ZSTD_e_end);
+        }
+        release();
+
+        // Synced before the file is renamed and its records reported to the checkpoint
+        if (::fsync(fd_) != 0) {
+            throw std::runtime_error("Failed to sync file: " + path_);
+        }
+        int fd = fd_;
+        fd_ = -1;
+        if (::close(fd) != 0) {
+            throw std::runtime_error("Failed to close file: " + path_);
+        }
+    }
+
+    // Bytes on disk so far
+    size_t bytesWritten() const { return bytesWritten_; }
+
+private:
+    void deflateChunks(const char* data, size_t size, int flush) {
+        gzip_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        gzip_.avail_in = static_cast<uInt>(size);
+        int result = Z_OK;
+        do {
+            gzip_.next_out = reinterpret_cast<Bytef*>(chunk_.data());
+            gzip_.avail_out = static_cast<uInt>(chunk_.size());
+            result = deflate(&gzip_, flush);
+            if (result == Z_STREAM_ERROR) {
+                throw std::runtime_error("gzip compression failed for " + path_);
+            }
+            writeOut(chunk_.data(), chunk_.size() - gzip_.avail_out);
+        } while (gzip_.avail_out == 0 || (flush == Z_FINISH && result != Z_STREAM_END));
+    }
+
+    void compressChunks(const char* data, size_t size, ZSTD_EndDirective mode) {
+        ZSTD_inBuffer input = {data, size, 0};
+        size_t remaining = 0;
+        do {
+            ZSTD_outBuffer output = {chunk_.data(), chunk_.size(), 0};
+            remaining = ZSTD_compressStream2(zstd_, &output, &input, mode);
+            if (ZSTD_isError(remaining)) {
+                throw std::runtime_error("zstd compression failed for " + path_ + ": " +
+                                         ZSTD_getErrorName(remaining));
+            }
+            writeOut(chunk_.data(), output.pos);
+        } while (input.pos < input.size || (mode == ZSTD_e_end && remaining != 0));
+    }
+
+    void writeOut(const char* data, size_t size) {
+        size_t offset = 0;
+        while (offset < size) {
+            ssize_t written = ::write(fd_, data + offset, size - offset);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("Failed to write file: " + path_ + ": " + std::strerror(errno));
+            }
+            offset += static_cast<size_t>(written);
+        }
+        bytesWritten_ += size;
+    }
+
+    void release() {
+        if (gzipActive_) {
+            deflateEnd(&gzip_);
+            gzipActive_ = false;
+        }
+        if (zstd_) {
+            ZSTD_freeCCtx(zstd_);
+            zstd_ = nullptr;
+        }
+    }
+
+    std::string path_;
+    int fd_ = -1;
+    z_stream gzip_ = {};
+    bool gzipActive_ = false;
+    ZSTD_CCtx* zstd_ = nullptr;
+    std::vector<char> chunk_;  // Compressor output
+    size_t bytesWritten_ = 0;
+};
+
+NdjsonDatabaseWriter::NdjsonDatabaseWriter(const std::string& outputDir, size_t batchSize,
+                                           const NdjsonWriterOptions& options)
+    : DatabaseWriter(batchSize), outputDir_(outputDir), options_(options) {
+    if (options_.compression == "gzip") {
+        extension_ = ".ndjson.gz";
+    } else if (options_.compression == "zstd") {
+        extension_ = ".ndjson.zst";
+    } else {
+        extension_ = ".ndjson";
+    }
+    buffer_.reserve(BUFFER_BYTES + 4096);
+    createOutputDirectory();
+}
+
+NdjsonDatabaseWriter::~NdjsonDatabaseWriter() {
+    shutdown();
+    finishFile();
+}
+
+std::string NdjsonDatabaseWriter::getName() const {
+    return "json";
+}
+
+void NdjsonDatabaseWriter::close() {
+    flush();
+    finishFile();
+}
+
+void NdjsonDatabaseWriter::removeIncompleteOutput() {
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(outputDir_, error)) {
+        std::string name = entry.path().filename().string();
+        if (isTemporaryFileName(name) && std::filesystem::remove(entry.path(), error)) {
+            spdlog::info("Removed incomplete JSON file {}", entry.path().string());
+        }
+    }
+}
+
+bool NdjsonDatabaseWriter::createOutputDirectory() {
+    try {
+        std::filesystem::create_directories(outputDir_);
+        spdlog::info("Created JSON output directory: {}", outputDir_);
+        return true;
+    } catch (const std::filesystem::filesystem_error& e) {
+        spdlog::error("Failed to create output directory {}: {}", outputDir_, e.what());
+        return false;
+    }
+}
+
+bool NdjsonDatabaseWriter::writeBatch(const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
+    // Records in the open file from earlier batches and from this one
+    size_t earlierRows = fileRows_;
+    size_t batchRows = 0;
+    size_t appended = 0;
+    try {
+        for (const auto& record : records) {
+            appendRecord(record);
+            appended++;
+            batchRows++;
+            if (buffer_.size() >= BUFFER_BYTES) {
+                flushBuffer();
+                if (file_->bytesWritten() >= options_.fileBytes) {
+                    closeFile();
+                    earlierRows = 0;
+                    batchRows = 0;
+                }
+            }
+        }
+
+        // A slowly filling file would otherwise hold back the checkpoint until it reaches fileBytes
+        if (fileExpired()) {
+            closeFile();
+        }
+        return true;
+    } catch (const std::exception& e) {
+        // Records of closed files are stored, those of the open one are lost with it
+        fail("Failed to write JSON file " + filePath_ + ": " + e.what(), earlierRows, appended - batchRows);
+        abandonFile();
+        return false;
+    }
+}
+
+void NdjsonDatabaseWriter::appendRecord(const ethereum_decoder::DecodedLogRecord& record) {
+    buffer_ += "{\"transaction_hash\":";
+    appendJsonString(buffer_, record.transactionHash);
+    buffer_ += ",\"block_number\":";
+    buffer_ += std::to_string(record.blockNumber);
+    buffer_ += ",\"log_index\":";
+    buffer_ += std::to_string(record.logIndex);
+    buffer_ += ",\"contract_address\":";
+    appendJsonString(buffer_, record.contractAddress);
+    buffer_ += ",\"event_name\":";
+    appendJsonString(buffer_, record.eventName);
+    buffer_ += ",\"event_signature\":";
+    appendJsonString(buffer_, record.eventSignature);
+    buffer_ += ",\"signature\":";
+    appendJsonString(buffer_, record.signature);
+    // args is serialized JSON already and goes in as is
+    buffer_ += ",\"args\":";
+    buffer_ += record.args.empty() ? "null" : record.args;
+    buffer_ += "}\n";
+
+    if (fileRows_ == 0) {
+        fileStarted_ = std::chrono::steady_clock::now();
+        fileFirstBlock_ = record.blockNumber;
+        fileLastBlock_ = record.blockNumber;
+    } else {
+        fileFirstBlock_ = std::min(fileFirstBlock_, record.blockNumber);
+        fileLastBlock_ = std::max(fileLastBlock_, record.blockNumber);
+    }
+    fileRows_++;
+    if (hasWrittenCallback()) {
+        filePositions_.push_back({record.blockNumber, record.logIndex});
+    }
+}
+
+void NdjsonDatabaseWriter::flushBuffer() {
+    if (buffer_.empty()) {
+        return;
+    }
+    if (!file_) {
+        openFile();
+    }
+    file_->write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+void NdjsonDatabaseWriter::openFile() {
+    // Hidden until closed, readers never pick up a partial file
+    filePath_ = outputDir_ + "/.blocks_" + std::to_string(fileSequence_++) + extension_ + ".tmp";
+    file_ = std::make_unique<NdjsonFile>(filePath_, options_.compression);
+}
+
+void NdjsonDatabaseWriter::closeFile() {
+    if (fileRows_ == 0) {
+        return;
+    }
+
+    flushBuffer();
+    file_->finish();
+
+    // Records arrive in decode order, so files of neighbouring ranges may overlap
+    std::string base = outputDir_ + "/blocks_" + std::to_string(fileFirstBlock_) + "-" +
+                       std::to_string(fileLastBlock_);
+    std::string finalPath = base + extension_;
+    for (size_t n = 1; std::filesystem::exists(finalPath); ++n) {
+        finalPath = base + "_" + std::to_string(n) + extension_;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(filePath_, finalPath, error);
+    if (error) {
+        throw std::runtime_error("Failed to rename " + filePath_ + " to " + finalPath + ": " + error.message());
+    }
+    syncDirectory(outputDir_);
+    spdlog::info("✓ JSON file {}: {} records", finalPath, fileRows_);
+
+    file_.reset();
+    fileRows_ = 0;
+    std::vector<LogPosition> positions;
+    positions.swap(filePositions_);
+    reportWritten(positions);
+}
+
+bool NdjsonDatabaseWriter::fileExpired() const {
+    return fileRows_ > 0 && options_.fileSeconds > 0 &&
+           std::chrono::steady_clock::now() - fileStarted_ >= std::chrono::seconds(options_.fileSeconds);
+}
+
+void NdjsonDatabaseWriter::finishFile() {
+    try {
+        closeFile();
+    } catch (const std::exception& e) {
+        fail("Failed to close JSON file " + filePath_ + ": " + e.what(), fileRows_);
+        abandonFile();
+    }
+}
+
+void NdjsonDatabaseWriter::abandonFile() {
+    if (file_) {
+        spdlog::warn("Leaving incomplete JSON file {} in place, its complete lines are still readable", filePath_);
+    }
+    file_.reset();
+    buffer_.clear();
+    fileRows_ = 0;
+    filePositions_.clear();
+}
+
+void NdjsonDatabaseWriter::onBatchWritten(size_t recordCount) {
+    spdlog::info("✓ JSON batch: wrote {} decoded logs to files (total: {})",
+                 recordCount, getTotalWritten() + recordCount);
+}
+
+void NdjsonDatabaseWriter::onBatchFailed(size_t recordCount, const std::string& error) {
+    spdlog::error("⚠ JSON batch failed: {} logs - {} (total failed: {})",
+                  recordCount, error, totalFailed_ + recordCount);
+}
+
+} // namespace decode_clickhouse
@@ -0,0 +1,345 @@
+#include "include/parquet/event_schema.h"
+
+#ifdef ENABLE_PARQUET
+
+#include "../../../ethereum_decoder/include/decoding/abi_type_parser.h"
+#include "../../../ethereum_decoder/include/json/json_decoder.h"
+#include "../../../ethereum_decoder/include/utils.h"
+#include <arrow/builder.h>
+#include <cstdio>
+#include <set>
+
+namespace decode_clickhouse {
+
+namespace {
+
+using ethereum_decoder::ABIOpcode;
+using ethereum_decoder::ABITypeInfo;
+using ethereum_decoder::ABITypeParser;
+
+// Columns every event dataset starts with
+constexpr int LOG_COLUMNS = 4;
+
+// FNV-1a, stable across runs so a layout keeps its directory
+uint32_t layoutHash(const std::string& key) {
+    uint32_t hash = 2166136261u;
+    for (unsigned char c : key) {
+        hash = (hash ^ c) * 16777619u;
+    }
+    return hash;
+}
+
+// Hex text of exactly width bytes, as formatted by the decoder
+bool parseHex(const std::string& hex, size_t width, uint8_t* out) {
+    try {
+        ethereum_decoder::Utils::hexToBytes(hex, out, width);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// Two's-complement 256-bit word from decimal text with an optional sign
+bool parseWord(const std::string& text, uint8_t* out) {
+    try {
+        bool negative = !text.empty() && text[0] == '-';
+        auto value = ethereum_decoder::UInt256::fromDecimal(std::string_view(text).substr(negative ? 1 : 0));
+        (negative ? value.negate() : value).toBigEndian(out);
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // anonymous namespace
+
+EventSchema::EventSchema(const ethereum_decoder::DecodedLogRecord& record) {
+    std::vector<std::shared_ptr<arrow::Field>> fields = {
+        arrow::field("transaction_hash", arrow::utf8()),
+        arrow::field("block_number", arrow::uint64()),
+        arrow::field("log_index", arrow::uint32()),
+        arrow::field("contract_address", arrow::utf8())
+    };
+    std::set<std::string> names;
+    for (const auto& field : fields) {
+        names.insert(field->name());
+    }
+
+    const auto& params = *record.params;
+    for (size_t i = 0; i < params.size(); ++i) {
+        // Unnamed parameters and names taken by another column get their position appended
+        std::string name = params[i].name.empty() ? "param_" + std::to_string(i) : params[i].name;
+        if (names.count(name)) {
+            name += "_" + std::to_string(i);
+        }
+        names.insert(name);
+
+        columns_.push_back(columnFor(params[i]));
+        fields.push_back(arrow::field(name, arrowType(columns_.back())));
+    }
+    schema_ = arrow::schema(std::move(fields));
+
+    char hash[9];
+    std::snprintf(hash, sizeof(hash), "%08x", layoutHash(layoutKey(record)));
+    datasetName_ = (record.eventName.empty() ? "event" : record.eventName) + "_" + hash;
+}
+
+std::string EventSchema::layoutKey(const ethereum_decoder::DecodedLogRecord& record) {
+    std::string key = record.eventSignature;
+    for (const auto& param : *record.params) {
+        key += "|" + param.name + ":" + param.type + (param.indexed ? ":indexed" : "");
+    }
+    return key;
+}
+
+EventSchema::ParamColumn EventSchema::columnFor(const ethereum_decoder::DecodedParam& param) {
+    ParamColumn column;
+    ABITypeInfo info;
+    if (!ABITypeParser::parse(param.type, info)) {
+        return column;
+    }
+
+    const bool array = info.opcode == ABIOpcode::DynamicArray || info.opcode == ABIOpcode::FixedArray;
+    if (param.indexed && (array || info.opcode == ABIOpcode::Tuple || ABITypeParser::isDynamic(param.type))) {
+        column.kind = ValueKind::FixedBytes;
+        column.byteWidth = 32;
+        return column;
+    }
+
+    if (array) {
+        std::string_view element = info.inner;
+        if (!ABITypeParser::parse(element, info) || info.opcode == ABIOpcode::DynamicArray ||
+            info.opcode == ABIOpcode::FixedArray || info.opcode == ABIOpcode::Tuple) {
+            return column;
+        }
+        column.list = true;
+    }
+
+    switch (info.opcode) {
+        case ABIOpcode::Address:
+            column.kind = ValueKind::Address;
+            column.byteWidth = 20;
+            break;
+        case ABIOpcode::Uint:
+        case ABIOpcode::Int:
+            column.isSigned = info.opcode == ABIOpcode::Int;
+            if (info.size <= 64) {
+                column.kind = column.isSigned ? ValueKind::Int64 : ValueKind::UInt64;
+            } else if (info.size < 256) {
+                // Up to 248 bits fit into 76 decimal digits
+                column.kind = ValueKind::Decimal;
+            } else {
+                column.kind = ValueKind::Word;
+                column.byteWidth = 32;
+            }
+            break;
+        case ABIOpcode::Bool:
+            column.kind = ValueKind::Bool;
+            break;
+        case ABIOpcode::FixedBytes:
+            column.kind = ValueKind::FixedBytes;
+            column.byteWidth = info.size;
+            break;
+        case ABIOpcode::Bytes:
+            column.kind = ValueKind::Bytes;
+            break;
+        case ABIOpcode::String:
+            column.kind = ValueKind::String;
+            break;
+        default:
+            column.list = false;
+            break;
+    }
+    return column;
+}
+
+std::shared_ptr<arrow::DataType> EventSchema::arrowType(const ParamColumn& column) {
+    std::shared_ptr<arrow::DataType> type;
+    switch (column.kind) {
+        case ValueKind::Address:
+        case ValueKind::Word:
+        case ValueKind::FixedBytes:
+            type = arrow::fixed_size_binary(static_cast<int32_t>(column.byteWidth));
+            break;
+        case ValueKind::UInt64:
+            type = arrow::uint64();
+            break;
+        case ValueKind::Int64:
+            type = arrow::int64();
+            break;
+        case ValueKind::Decimal:
+            type = arrow::decimal256(76, 0);
+            break;
+        case ValueKind::Bytes:
+            type = arrow::binary();
+            break;
+        case ValueKind::Bool:
+            type = arrow::boolean();
+            break;
+        case ValueKind::String:
+        case ValueKind::Json:
+            type = arrow::utf8();
+            break;
+    }
+    return column.list ? arrow::list(type) : type;
+}
+
+arrow::Status EventSchema::append(const ethereum_decoder::DecodedLogRecord& record, ParquetDataset& dataset) const {
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(0).Append(record.transactionHash));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::UInt64Builder>(1).Append(record.blockNumber));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::UInt32Builder>(2).Append(record.logIndex));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(3).Append(record.contractAddress));
+
+    const auto& params = *record.params;
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        auto& builder = dataset.column<arrow::ArrayBuilder>(LOG_COLUMNS + static_cast<int>(i));
+        if (i >= params.size()) {
+            ARROW_RETURN_NOT_OK(builder.AppendNull());
+            continue;
+        }
+
+        const ParamColumn& column = columns_[i];
+        if (!column.list) {
+            ARROW_RETURN_NOT_OK(appendValue(column, params[i].value, builder));
+            continue;
+        }
+
+        const auto* elements = std::get_if<std::vector<std::string>>(&params[i].value);
+        if (!elements) {
+            ARROW_RETURN_NOT_OK(builder.AppendNull());
+            continue;
+        }
+        auto& list = static_cast<arrow::ListBuilder&>(builder);
+        ARROW_RETURN_NOT_OK(list.Append());
+        for (const auto& element : *elements) {
+            ARROW_RETURN_NOT_OK(appendElement(column, element, *list.value_builder()));
+        }
+    }
+    return arrow::Status::OK();
+}
+
+arrow::Status EventSchema::appendValue(const ParamColumn& column, const ethereum_decoder::DecodedValue& value,
+                                       arrow::ArrayBuilder& builder) {
+    using namespace ethereum_decoder;
+
+    switch (column.kind) {
+        case ValueKind::Address:
+            if (const auto* address = std::get_if<AddressBytes>(&value)) {
+                return static_cast<arrow::FixedSizeBinaryBuilder&>(builder).Append(address->data());
+            }
+            break;
+        case ValueKind::UInt64:
+            if (const auto* number = std::get_if<UInt256>(&value)) {
+                return static_cast<arrow::UInt64Builder&>(builder).Append(number->low64());
+            }
+            break;
+        case ValueKind::Int64:
+            if (const auto* number = std::get_if<Int256>(&value)) {
+                // Sign-extended by the decoder, so the low word is the value
+                return static_cast<arrow::Int64Builder&>(builder).Append(static_cast<int64_t>(number->bits.low64()));
+            }
+            break;
+        case ValueKind::Decimal:
+        case ValueKind::Word:
+            if (std::holds_alternative<UInt256>(value) || std::holds_alternative<Int256>(value)) {
+                const UInt256& bits = std::holds_alternative<UInt256>(value) ? std::get<UInt256>(value)
+                                                                             : std::get<Int256>(value).bits;
+                if (column.kind == ValueKind::Word) {
+                    uint8_t word[UInt256::BYTES];
+                    bits.toBigEndian(word);
+                    return static_cast<arrow::FixedSizeBinaryBuilder&>(builder).Append(word);
+                }
+                return appendElement(column, column.isSigned ? bits.toSignedDecimal() : bits.toDecimal(), builder);
+            }
+            break;
+        case ValueKind::Bool:
+            if (const auto* flag = std::get_if<bool>(&value)) {
+                return static_cast<arrow::BooleanBuilder&>(builder).Append(*flag);
+            }
+            break;
+        case ValueKind::FixedBytes:
+            if (const auto* word = std::get_if<Bytes32>(&value); word && column.byteWidth == word->size()) {
+                return static_cast<arrow::FixedSizeBinaryBuilder&>(builder).Append(word->data());
+            }
+            if (const auto* bytes = std::get_if<std::vector<uint8_t>>(&value); bytes && column.byteWidth == bytes->size()) {
+                return static_cast<arrow::FixedSizeBinaryBuilder&>(builder).Append(bytes->data());
+            }
+            if (const auto* hash = std::get_if<std::string>(&value)) {
+                // Topic hash of an indexed dynamic value
+                return appendElement(column, *hash, builder);
+            }
+            break;
+        case ValueKind::Bytes:
+            if (const auto* bytes = std::get_if<std::vector<uint8_t>>(&value)) {
+                return static_cast<arrow::BinaryBuilder&>(builder).Append(bytes->data(),
+                                                                          static_cast<int32_t>(bytes->size()));
+            }
+            break;
+        case ValueKind::String:
+            if (const auto* text = std::get_if<std::string>(&value)) {
+                return static_cast<arrow::StringBuilder&>(builder).Append(*text);
+            }
+            break;
+        case ValueKind::Json:
+            return static_cast<arrow::StringBuilder&>(builder).Append(JsonDecoder::decodedValueToJson(value).dump());
+    }
+    return builder.AppendNull();
+}
+
+arrow::Status EventSchema::appendElement(const ParamColumn& column, const std::string& element,
+                                         arrow::ArrayBuilder& builder) {
+    switch (column.kind) {
+        case ValueKind::Address:
+        case ValueKind::FixedBytes: {
+            std::vector<uint8_t> bytes(column.byteWidth);
+            if (parseHex(element, column.byteWidth, bytes.data())) {
+                return static_cast<arrow::FixedSizeBinaryBuilder&>(builder).Append(bytes.data());
+            }
+            break;
+        }
+        case ValueKind::UInt64:
+        case ValueKind::Int64:
+        case ValueKind::Word: {
+            uint8_t word[ethereum_decoder::UInt256::BYTES];
+            if (!parseWord(element, word)) {
+                break;
+            }
+            if (column.kind == ValueKind::Word) {
+                return static_cast<arrow::FixedSizeBinaryBuilder&>(builder).Append(word);
+            }
+            uint64_t low = ethereum_decoder::UInt256::fromBigEndian(word + 24, 8).low64();
+            if (column.kind == ValueKind::UInt64) {
+                return static_cast<arrow::UInt64Builder&>(builder).Append(low);
+            }
+            return static_cast<arrow::Int64Builder&>(builder).Append(static_cast<int64_t>(low));
+        }
+        case ValueKind::Decimal: {
+            auto decimal = arrow::Decimal256::FromString(element);
+            if (decimal.ok()) {
+                return static_cast<arrow::Decimal256Builder&>(builder).Append(decimal.ValueOrDie());
+            }
+            break;
+        }
+        case ValueKind::Bool:
+            if (element == "true" || element == "false") {
+                return static_cast<arrow::BooleanBuilder&>(builder).Append(element == "true");
+            }
+            break;
+        case ValueKind::Bytes:
+            try {
+                auto bytes = ethereum_decoder::Utils::hexToBytes(element);
+                return static_cast<arrow::BinaryBuilder&>(builder).Append(bytes.data(),
+                                                                          static_cast<int32_t>(bytes.size()));
+            } catch (const std::exception&) {
+            }
+            break;
+        case ValueKind::String:
+        case ValueKind::Json:
+            return static_cast<arrow::StringBuilder&>(builder).Append(element);
+    }
+    return builder.AppendNull();
+}
+
+} // namespace decode_clickhouse
+
+#endif // ENABLE_PARQUET
@@ -1,78 +1,118 @@
 #include "include/parquet/parquet_database_writer.h"
-#include <spdlog/spdlog.h>
-#include <filesystem>
-#include <fstream>
-#include <nlohmann/json.hpp>
-#include <map>
 
 #ifdef ENABLE_PARQUET
+
+#include <spdlog/spdlog.h>
 #include <arrow/builder.h>
-#include <arrow/io/file.h>
-#include <parquet/arrow/writer.h>
-#endif
+#include <chrono>
+#include <filesystem>
 
 namespace decode_clickhouse {
 
-ParquetDatabaseWriter::ParquetDatabaseWriter(const std::string& outputDir, size_t batchSize, bool forceJsonOutput)
-    : DatabaseWriter(batchSize), outputDir_(outputDir), forceJsonOutput_(forceJsonOutput) {
+ParquetDatabaseWriter::ParquetDatabaseWriter(const std::string& outputDir, size_t batchSize,
+                                             const ParquetWriterOptions& options)
+    : DatabaseWriter(batchSize), outputDir_(outputDir), options_(options) {
     createOutputDirectory();
+    dataset_ = std::make_unique<ParquetDataset>(outputDir_, createSchema(), options_);
 }
 
-bool ParquetDatabaseWriter::createOutputDirectory() {
-    try {
-        std::filesystem::create_directories(outputDir_);
-        std::string format = forceJsonOutput_ ? "JSON" : "Parquet";
-        spdlog::info("Created {} output directory: {}", format, outputDir_);
-        return true;
-    } catch (const std::filesystem::filesystem_error& e) {
-        spdlog::error("Failed to create output directory {}: {}", outputDir_, e.what());
-        return false;
+ParquetDatabaseWriter::~ParquetDatabaseWriter() {
+    shutdown();
+    finishFiles();
+}
+
+void ParquetDatabaseWriter::close() {
+    flush();
+    finishFiles();
+}
+
+void ParquetDatabaseWriter::finishFiles() {
+    std::vector<LogPosition> closedPositions;
+    std::vector<LogPosition>* positions = hasWrittenCallback() ? &closedPositions : nullptr;
+
+    closeFile(*dataset_, positions, dataset_->fileRows());
+    for (auto& [layout, eventDataset] : eventDatasets_) {
+        closeFile(*eventDataset.dataset, positions, eventDataset.dataset->fileRows());
+    }
+    if (!closedPositions.empty()) {
+        reportWritten(closedPositions);
     }
 }
 
-bool ParquetDatabaseWriter::writeBatch(const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
-    try {
-        writeRecordsByBlock(records);
-        return true;
-    } catch (const std::exception& e) {
-        spdlog::error("Exception during parquet batch write: {}", e.what());
+bool ParquetDatabaseWriter::closeFile(ParquetDataset& dataset, std::vector<LogPosition>* positions,
+                                      size_t lostRecords, size_t storedRecords) {
+    auto status = dataset.close(positions);
+    if (!status.ok()) {
+        fail("Failed to close parquet file " + dataset.filePath() + ": " + status.ToString(), lostRecords,
+             storedRecords);
+        dataset.discard();
         return false;
     }
+    return true;
 }
 
-void ParquetDatabaseWriter::writeRecordsByBlock(const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
-    // Group records by block number
-    std::map<uint64_t, std::vector<ethereum_decoder::DecodedLogRecord>> recordsByBlock;
-    for (const auto& record : records) {
-        recordsByBlock[record.blockNumber].push_back(record);
+bool ParquetDatabaseWriter::closeExpiredFiles(std::vector<LogPosition>* positions,
+                                              const std::map<ParquetDataset*, OpenRows>& openRows,
+                                              size_t batchRecords) {
+    auto now = std::chrono::steady_clock::now();
+    auto closeExpired = [&](ParquetDataset& dataset) {
+        if (!dataset.expired(now)) {
+            return true;
+        }
+        // Only the file's own rows are lost: those of this batch in other datasets are stored
+        auto it = openRows.find(&dataset);
+        OpenRows rows = it != openRows.end() ? it->second : OpenRows{dataset.fileRows(), 0};
+        return closeFile(dataset, positions, rows.earlier, batchRecords - rows.batch);
+    };
+
+    if (!closeExpired(*dataset_)) {
+        return false;
     }
-
-    // Write each block's records to separate files
-    for (const auto& [blockNumber, blockRecords] : recordsByBlock) {
-        if (!writeBlockRecords(blockNumber, blockRecords)) {
-            throw std::runtime_error("Failed to write records for block " + std::to_string(blockNumber));
+    for (auto& [layout, eventDataset] : eventDatasets_) {
+        if (!closeExpired(*eventDataset.dataset)) {
+            return false;
         }
     }
+    return true;
 }
 
-bool ParquetDatabaseWriter::writeBlockRecords(uint64_t blockNumber, const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
-    if (records.empty()) {
-        spdlog::debug("No records to write for block {}", blockNumber);
-        return true;
+void ParquetDatabaseWriter::removeIncompleteOutput() {
+    ParquetDataset::removeTemporaryFiles(outputDir_);
+
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(outputDir_ + "/events", error)) {
+        if (entry.is_directory()) {
+            ParquetDataset::removeTemporaryFiles(entry.path().string());
+        }
     }
+}
 
-#ifdef ENABLE_PARQUET
-    if (forceJsonOutput_) {
-        return writeBlockRecordsAsJSON(blockNumber, records);
-    } else {
-        return writeBlockRecordsAsParquet(blockNumber, records);
+std::string ParquetDatabaseWriter::getName() const {
+    return "parquet";
+}
+
+bool ParquetDatabaseWriter::needsDecodedParams() const {
+    return options_.perEvent;
+}
+
+bool ParquetDatabaseWriter::defersWrittenReport() const {
+    return true;
+}
+
+bool ParquetDatabaseWriter::createOutputDirectory() {
+    try {
+        std::filesystem::create_directories(outputDir_);
+        spdlog::info("Created Parquet output directory: {}", outputDir_);
+        return true;
+    } catch (const std::filesystem::filesystem_error& e) {
+        spdlog::error("Failed to create output directory {}: {}", outputDir_, e.what());
+        return false;
     }
-#else
-    return writeBlockRecordsAsJSON(blockNumber, records);
-#endif
 }
 
-#ifdef ENABLE_PARQUET
+bool ParquetDatabaseWriter::writeBatch(const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
+    return appendRecords(records);
+}
 
 std::shared_ptr<arrow::Schema> ParquetDatabaseWriter::createSchema() {
     return arrow::schema({
@@ -87,241 +127,96 @@ std::shared_ptr<arrow::Schema> ParquetDatabaseWriter::createSchema() {
     });
 }
 
-std::shared_ptr<arrow::RecordBatch> ParquetDatabaseWriter::createRecordBatch(const std::vector<ethereum_decoder::DecodedLogRecord>& logs) {
-    arrow::StringBuilder transactionHashBuilder;
-    arrow::UInt64Builder blockNumberBuilder;
-    arrow::UInt32Builder logIndexBuilder;
-    arrow::StringBuilder contractAddressBuilder;
-    arrow::StringBuilder eventNameBuilder;
-    arrow::StringBuilder eventSignatureBuilder;
-    arrow::StringBuilder signatureBuilder;
-    arrow::StringBuilder argsBuilder;
-    
-    for (const auto& log : logs) {
-        auto status = transactionHashBuilder.Append(log.transactionHash);
-        if (!status.ok()) {
-            spdlog::error("Failed to append transaction hash: {}", status.ToString());
-            return nullptr;
-        }
-        
-        status = blockNumberBuilder.Append(log.blockNumber);
-        if (!status.ok()) {
-            spdlog::error("Failed to append block number: {}", status.ToString());
-            return nullptr;
-        }
-        
-        status = logIndexBuilder.Append(log.logIndex);
-        if (!status.ok()) {
-            spdlog::error("Failed to append log index: {}", status.ToString());
-            return nullptr;
-        }
-        
-        status = contractAddressBuilder.Append(log.contractAddress);
-        if (!status.ok()) {
-            spdlog::error("Failed to append contract address: {}", status.ToString());
-            return nullptr;
-        }
-        
-        status = eventNameBuilder.Append(log.eventName);
-        if (!status.ok()) {
-            spdlog::error("Failed to append event name: {}", status.ToString());
-            return nullptr;
-        }
-        
-        status = eventSignatureBuilder.Append(log.eventSignature);
-        if (!status.ok()) {
-            spdlog::error("Failed to append event signature: {}", status.ToString());
-            return nullptr;
-        }
-        
-        status = signatureBuilder.Append(log.signature);
-        if (!status.ok()) {
-            spdlog::error("Failed to append signature: {}", status.ToString());
-            return nullptr;
-        }
-        
-        status = argsBuilder.Append(log.args);
-        if (!status.ok()) {
-            spdlog::error("Failed to append args: {}", status.ToString());
-            return nullptr;
-        }
-    }
-    
-    std::shared_ptr<arrow::Array> transactionHashArray;
-    std::shared_ptr<arrow::Array> blockNumberArray;
-    std::shared_ptr<arrow::Array> logIndexArray;
-    std::shared_ptr<arrow::Array> contractAddressArray;
-    std::shared_ptr<arrow::Array> eventNameArray;
-    std::shared_ptr<arrow::Array> eventSignatureArray;
-    std::shared_ptr<arrow::Array> signatureArray;
-    std::shared_ptr<arrow::Array> argsArray;
-    
-    auto status = transactionHashBuilder.Finish(&transactionHashArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish transaction hash array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    status = blockNumberBuilder.Finish(&blockNumberArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish block number array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    status = logIndexBuilder.Finish(&logIndexArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish log index array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    status = contractAddressBuilder.Finish(&contractAddressArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish contract address array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    status = eventNameBuilder.Finish(&eventNameArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish event name array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    status = eventSignatureBuilder.Finish(&eventSignatureArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish event signature array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    status = signatureBuilder.Finish(&signatureArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish signature array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    status = argsBuilder.Finish(&argsArray);
-    if (!status.ok()) {
-        spdlog::error("Failed to finish args array: {}", status.ToString());
-        return nullptr;
-    }
-    
-    auto schema = createSchema();
-    auto recordBatch = arrow::RecordBatch::Make(schema, logs.size(), {
-        transactionHashArray,
-        blockNumberArray,
-        logIndexArray,
-        contractAddressArray,
-        eventNameArray,
-        eventSignatureArray,
-        signatureArray,
-        argsArray
-    });
-    
-    return recordBatch;
+arrow::Status ParquetDatabaseWriter::appendRecord(const ethereum_decoder::DecodedLogRecord& record,
+                                                  ParquetDataset& dataset) {
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(0).Append(record.transactionHash));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::UInt64Builder>(1).Append(record.blockNumber));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::UInt32Builder>(2).Append(record.logIndex));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(3).Append(record.contractAddress));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(4).Append(record.eventName));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(5).Append(record.eventSignature));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(6).Append(record.signature));
+    ARROW_RETURN_NOT_OK(dataset.column<arrow::StringBuilder>(7).Append(record.args));
+    return arrow::Status::OK();
 }
 
-bool ParquetDatabaseWriter::writeBlockRecordsAsParquet(uint64_t blockNumber, const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
-    try {
-        std::string filename = getBlockFilename(blockNumber);
-        
-        // Create Arrow record batch from records
-        auto recordBatch = createRecordBatch(records);
-        if (!recordBatch) {
-            spdlog::error("Failed to create record batch for block {}", blockNumber);
+ParquetDatabaseWriter::EventDataset& ParquetDatabaseWriter::eventDataset(
+        const ethereum_decoder::DecodedLogRecord& record) {
+    std::string layout = EventSchema::layoutKey(record);
+    auto it = eventDatasets_.find(layout);
+    if (it != eventDatasets_.end()) {
+        return it->second;
+    }
+
+    EventDataset eventDataset;
+    eventDataset.schema = std::make_unique<EventSchema>(record);
+    std::string directory = outputDir_ + "/events/" + eventDataset.schema->datasetName();
+    std::filesystem::create_directories(directory);
+    eventDataset.dataset = std::make_unique<ParquetDataset>(directory, eventDataset.schema->schema(), options_);
+    spdlog::info("Parquet dataset {} for {}", directory, record.eventSignature);
+    return eventDatasets_.emplace(std::move(layout), std::move(eventDataset)).first->second;
+}
+
+bool ParquetDatabaseWriter::appendRecords(const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
+    // Datasets are created first, so failing to create one fails the batch before any of it is added
+    std::vector<EventDataset*> events(records.size(), nullptr);
+    if (options_.perEvent) {
+        try {
+            for (size_t i = 0; i < records.size(); ++i) {
+                if (records[i].params) {
+                    events[i] = &eventDataset(records[i]);
+                }
+            }
+        } catch (const std::exception& e) {
+            spdlog::error("Failed to create parquet dataset: {}", e.what());
             return false;
         }
-        
-        // Open file for writing
-        std::shared_ptr<arrow::io::FileOutputStream> outfile;
-        auto file_result = arrow::io::FileOutputStream::Open(filename);
-        if (!file_result.ok()) {
-            spdlog::error("Failed to open file {} for writing: {}", filename, file_result.status().ToString());
-            return false;
+    }
+
+    std::vector<LogPosition> closedPositions;
+    std::vector<LogPosition>* positions = hasWrittenCallback() ? &closedPositions : nullptr;
+    bool success = true;
+
+    std::map<ParquetDataset*, OpenRows> openRows;
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        const auto& record = records[i];
+        ParquetDataset& dataset = events[i] ? *events[i]->dataset : *dataset_;
+        auto [it, added] = openRows.try_emplace(&dataset);
+        OpenRows& rows = it->second;
+        if (added) {
+            rows.earlier = dataset.fileRows();
         }
-        outfile = file_result.ValueOrDie();
-        
-        // Create parquet writer
-        auto writer_result = parquet::arrow::FileWriter::Open(*recordBatch->schema(), arrow::default_memory_pool(), outfile, 
-                                                      parquet::default_writer_properties(), 
-                                                      parquet::default_arrow_writer_properties());
-        if (!writer_result.ok()) {
-            spdlog::error("Failed to create parquet writer for file {}: {}", filename, writer_result.status().ToString());
-            return false;
+
+        arrow::Status status = events[i] ? events[i]->schema->append(record, dataset) : appendRecord(record, dataset);
+        if (status.ok()) {
+            status = dataset.addRow(record.blockNumber, record.logIndex, positions);
         }
-        std::unique_ptr<parquet::arrow::FileWriter> writer = std::move(writer_result.ValueOrDie());
-        
-        // Write the record batch
-        auto write_status = writer->WriteRecordBatch(*recordBatch);
-        if (!write_status.ok()) {
-            spdlog::error("Failed to write record batch to file {}: {}", filename, write_status.ToString());
-            return false;
+        if (!status.ok()) {
+            // The open file is broken: its rows are lost, rows in the other datasets are kept
+            fail("Failed to write parquet file " + dataset.filePath() + ": " + status.ToString(), rows.earlier,
+                 i - rows.batch);
+            dataset.discard();
+            success = false;
+            break;
         }
-        
-        // Close the writer
-        auto close_status = writer->Close();
-        if (!close_status.ok()) {
-            spdlog::error("Failed to close parquet writer for file {}: {}", filename, close_status.ToString());
-            return false;
+
+        if (dataset.fileRows() == 0) {
+            rows = OpenRows();  // The row closed the file
+        } else {
+            rows.batch++;
         }
-        
-        spdlog::debug("Wrote {} records for block {} to parquet file {}", records.size(), blockNumber, filename);
-        return true;
-        
-    } catch (const std::exception& e) {
-        spdlog::error("Exception writing parquet file for block {}: {}", blockNumber, e.what());
-        return false;
     }
-}
-
-#endif // ENABLE_PARQUET
 
-std::string ParquetDatabaseWriter::getBlockFilename(uint64_t blockNumber) const {
-#ifdef ENABLE_PARQUET
-    if (forceJsonOutput_) {
-        return outputDir_ + "/block_" + std::to_string(blockNumber) + ".json";
-    } else {
-        return outputDir_ + "/block_" + std::to_string(blockNumber) + ".parquet";
+    // Files of rarely seen events would otherwise stay open, and hold back the checkpoint, until close()
+    if (success) {
+        success = closeExpiredFiles(positions, openRows, records.size());
     }
-#else
-    return outputDir_ + "/block_" + std::to_string(blockNumber) + ".json";
-#endif
-}
 
-bool ParquetDatabaseWriter::writeBlockRecordsAsJSON(uint64_t blockNumber, const std::vector<ethereum_decoder::DecodedLogRecord>& records) {
-    try {
-        std::string filename = getBlockFilename(blockNumber);
-        
-        nlohmann::json jsonArray = nlohmann::json::array();
-        
-        for (const auto& record : records) {
-            nlohmann::json logJson = {
-                {"transaction_hash", record.transactionHash},
-                {"block_number", record.blockNumber},
-                {"log_index", record.logIndex},
-                {"contract_address", record.contractAddress},
-                {"event_name", record.eventName},
-                {"event_signature", record.eventSignature},
-                {"signature", record.signature},
-                {"args", record.args}
-            };
-            jsonArray.push_back(logJson);
-        }
-        
-        std::ofstream outFile(filename);
-        if (!outFile.is_open()) {
-            spdlog::error("Failed to open file {} for writing", filename);
-            return false;
-        }
-        
-        outFile << jsonArray.dump(2);
-        outFile.close();
-        
-        spdlog::debug("Wrote {} records for block {} to JSON file {}", records.size(), blockNumber, filename);
-        return true;
-        
-    } catch (const std::exception& e) {
-        spdlog::error("Exception writing JSON file for block {}: {}", blockNumber, e.what());
-        return false;
+    if (!closedPositions.empty()) {
+        reportWritten(closedPositions);
     }
+    return success;
 }
 
 void ParquetDatabaseWriter::onBatchWritten(size_t recordCount) {
@@ -334,4 +229,6 @@ void ParquetDatabaseWriter::onBatchFailed(size_t recordCount, const std::string&
                   recordCount, error, totalFailed_ + recordCount);
 }
 
-} // namespace decode_clickhouse
\ No newline at end of file
+} // namespace decode_clickhouse
+
+#endif // ENABLE_PARQUET
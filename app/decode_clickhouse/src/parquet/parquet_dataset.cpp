@@ -0,0 +1,244 @@
+#include "include/parquet/parquet_dataset.h"
+
+#ifdef ENABLE_PARQUET
+
+#include "include/log-writer/file_sync.h"
+#include <spdlog/spdlog.h>
+#include <arrow/builder.h>
+#include <arrow/table.h>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+
+namespace decode_clickhouse {
+
+namespace {
+
+arrow::Compression::type compressionCodec(const std::string& name) {
+    if (name == "none") {
+        return arrow::Compression::UNCOMPRESSED;
+    }
+    if (name == "snappy") {
+        return arrow::Compression::SNAPPY;
+    }
+    if (name == "gzip") {
+        return arrow::Compression::GZIP;
+    }
+    if (name == "lz4") {
+        return arrow::Compression::LZ4;
+    }
+    if (name == "zstd") {
+        return arrow::Compression::ZSTD;
+    }
+    throw std::runtime_error("Unsupported Parquet compression: " + name);
+}
+
+std::shared_ptr<parquet::WriterProperties> writerProperties(const arrow::Schema& schema,
+                                                            const ParquetWriterOptions& options) {
+    parquet::WriterProperties::Builder builder;
+    builder.compression(compressionCodec(options.compression));
+    if (options.compressionLevel) {
+        builder.compression_level(*options.compressionLevel);
+    }
+
+    // Column names select top-level columns; list columns follow the file-wide setting
+    if (!options.dictionaryAllColumns) {
+        builder.disable_dictionary();
+        for (const auto& column : options.dictionaryColumns) {
+            if (schema.GetFieldByName(column)) {
+                builder.enable_dictionary(column);
+            }
+        }
+    }
+    if (!options.statisticsAllColumns) {
+        builder.disable_statistics();
+        for (const auto& column : options.statisticsColumns) {
+            if (schema.GetFieldByName(column)) {
+                builder.enable_statistics(column);
+            }
+        }
+    }
+    return builder.build();
+}
+
+// Run a file_sync call, its exception as a status
+template <typename Sync>
+arrow::Status sync(Sync&& call) {
+    try {
+        call();
+    } catch (const std::exception& e) {
+        return arrow::Status::IOError(e.what());
+    }
+    return arrow::Status::OK();
+}
+
+} // anonymous namespace
+
+ParquetDataset::ParquetDataset(std::string directory, std::shared_ptr<arrow::Schema> schema,
+                               const ParquetWriterOptions& options)
+    : directory_(std::move(directory)), schema_(std::move(schema)), options_(options) {
+    if (options_.rowGroupRows == 0) {
+        options_.rowGroupRows = 1;
+    }
+    properties_ = writerProperties(*schema_, options_);
+
+    for (int i = 0; i < schema_->num_fields(); ++i) {
+        std::unique_ptr<arrow::ArrayBuilder> builder;
+        auto status = arrow::MakeBuilder(arrow::default_memory_pool(), schema_->field(i)->type(), &builder);
+        if (!status.ok()) {
+            throw std::runtime_error("Failed to create parquet column " + schema_->field(i)->name() + ": " +
+                                     status.ToString());
+        }
+        columns_.push_back(std::move(builder));
+    }
+}
+
+arrow::Status ParquetDataset::addRow(uint64_t blockNumber, uint64_t logIndex,
+                                     std::vector<LogPosition>* closedPositions) {
+    rowGroupRows_++;
+    if (fileRows_ == 0) {
+        fileStarted_ = std::chrono::steady_clock::now();
+        fileFirstBlock_ = blockNumber;
+        fileLastBlock_ = blockNumber;
+    } else {
+        fileFirstBlock_ = std::min(fileFirstBlock_, blockNumber);
+        fileLastBlock_ = std::max(fileLastBlock_, blockNumber);
+    }
+    fileRows_++;
+    if (closedPositions) {
+        filePositions_.push_back({blockNumber, logIndex});
+    }
+
+    if (fileRows_ >= options_.fileRows) {
+        return close(closedPositions);
+    }
+    if (rowGroupRows_ >= options_.rowGroupRows) {
+        ARROW_RETURN_NOT_OK(writeRowGroup());
+        ARROW_ASSIGN_OR_RAISE(int64_t fileBytes, file_->Tell());
+        if (static_cast<size_t>(fileBytes) >= options_.fileBytes) {
+            return close(closedPositions);
+        }
+    }
+    return arrow::Status::OK();
+}
+
+bool ParquetDataset::expired(std::chrono::steady_clock::time_point now) const {
+    return fileRows_ > 0 && options_.fileSeconds > 0 &&
+           now - fileStarted_ >= std::chrono::seconds(options_.fileSeconds);
+}
+
+arrow::Status ParquetDataset::writeRowGroup() {
+    if (rowGroupRows_ == 0) {
+        return arrow::Status::OK();
+    }
+    if (!fileWriter_) {
+        ARROW_RETURN_NOT_OK(openFile());
+    }
+
+    // Finish() also resets each builder for the next row group
+    std::vector<std::shared_ptr<arrow::Array>> arrays(columns_.size());
+    for (size_t i = 0; i < columns_.size(); ++i) {
+        ARROW_RETURN_NOT_OK(columns_[i]->Finish(&arrays[i]));
+    }
+    auto batch = arrow::RecordBatch::Make(schema_, static_cast<int64_t>(rowGroupRows_), std::move(arrays));
+    rowGroupRows_ = 0;
+
+    ARROW_ASSIGN_OR_RAISE(auto table, arrow::Table::FromRecordBatches(schema_, {batch}));
+    return fileWriter_->WriteTable(*table, batch->num_rows());
+}
+
+arrow::Status ParquetDataset::openFile() {
+    // Hidden until closed, readers never pick up a file without its footer
+    filePath_ = directory_ + "/.blocks_" + std::to_string(fileSequence_++) + ".parquet.tmp";
+    ARROW_ASSIGN_OR_RAISE(file_, arrow::io::FileOutputStream::Open(filePath_));
+    ARROW_ASSIGN_OR_RAISE(fileWriter_, parquet::arrow::FileWriter::Open(*schema_, arrow::default_memory_pool(), file_,
+                                                                       properties_,
+                                                                       parquet::default_arrow_writer_properties()));
+    return arrow::Status::OK();
+}
+
+arrow::Status ParquetDataset::close(std::vector<LogPosition>* closedPositions) {
+    if (fileRows_ == 0) {
+        return arrow::Status::OK();
+    }
+
+    ARROW_RETURN_NOT_OK(writeRowGroup());
+    ARROW_RETURN_NOT_OK(fileWriter_->Close());
+    ARROW_RETURN_NOT_OK(file_->Close());
+    // Synced before the file is renamed and its rows reported to the checkpoint
+    ARROW_RETURN_NOT_OK(sync([this] { syncFile(filePath_); }));
+
+    // Records arrive in decode order, so files of neighbouring ranges may overlap
+    std::string base = directory_ + "/blocks_" + std::to_string(fileFirstBlock_) + "-" +
+                       std::to_string(fileLastBlock_);
+    std::string finalPath = base + ".parquet";
+    for (size_t n = 1; std::filesystem::exists(finalPath); ++n) {
+        finalPath = base + "_" + std::to_string(n) + ".parquet";
+    }
+
+    std::error_code error;
+    std::filesystem::rename(filePath_, finalPath, error);
+    if (error) {
+        return arrow::Status::IOError("Failed to rename ", filePath_, " to ", finalPath, ": ", error.message());
+    }
+    ARROW_RETURN_NOT_OK(sync([this] { syncDirectory(directory_); }));
+    spdlog::info("✓ Parquet file {}: {} rows", finalPath, fileRows_);
+
+    fileWriter_.reset();
+    file_.reset();
+    fileRows_ = 0;
+    if (closedPositions) {
+        closedPositions->insert(closedPositions->end(), filePositions_.begin(), filePositions_.end());
+    }
+    filePositions_.clear();
+    return arrow::Status::OK();
+}
+
+void ParquetDataset::discard() {
+    if (fileWriter_) {
+        auto status = fileWriter_->Close();
+        (void)status;
+    }
+    if (file_ && !file_->closed()) {
+        auto status = file_->Close();
+        (void)status;
+    }
+    if (!filePath_.empty()) {
+        std::error_code error;
+        std::filesystem::remove(filePath_, error);
+    }
+
+    // Reset() drops whatever the builders hold
+    for (auto& column : columns_) {
+        column->Reset();
+    }
+    rowGroupRows_ = 0;
+
+    fileWriter_.reset();
+    file_.reset();
+    fileRows_ = 0;
+    filePositions_.clear();
+}
+
+size_t ParquetDataset::removeTemporaryFiles(const std::string& directory) {
+    // Open files are named .blocks_<n>.parquet.tmp
+    static const std::string prefix = ".blocks_";
+    static const std::string suffix = ".parquet.tmp";
+
+    size_t removed = 0;
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+        std::string name = entry.path().filename().string();
+        if (name.size() > prefix.size() + suffix.size() && name.compare(0, prefix.size(), prefix) == 0 &&
+            name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0 &&
+            std::filesystem::remove(entry.path(), error)) {
+            spdlog::info("Removed incomplete parquet file {}", entry.path().string());
+            removed++;
+        }
+    }
+    return removed;
+}
+
+} // namespace decode_clickhouse
+
+#endif // ENABLE_PARQUET
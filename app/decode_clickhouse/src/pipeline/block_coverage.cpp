@@ -0,0 +1,28 @@
+#include "include/pipeline/block_coverage.h"
+
+namespace decode_clickhouse {
+
+BlockCoverage::BlockCoverage(uint64_t startBlock, uint64_t endBlock)
+    : startBlock_(startBlock), endBlock_(endBlock) {
+    size_t numWords = endBlock >= startBlock ? static_cast<size_t>((endBlock - startBlock) / 64 + 1) : 0;
+    words_ = std::make_unique<std::atomic<uint64_t>[]>(numWords);
+    for (size_t i = 0; i < numWords; ++i) {
+        words_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool BlockCoverage::add(uint64_t block) {
+    if (block < startBlock_ || block > endBlock_) {
+        return false;
+    }
+
+    uint64_t offset = block - startBlock_;
+    uint64_t bit = uint64_t(1) << (offset % 64);
+    if (words_[offset / 64].fetch_or(bit, std::memory_order_relaxed) & bit) {
+        return false;
+    }
+    count_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+} // namespace decode_clickhouse
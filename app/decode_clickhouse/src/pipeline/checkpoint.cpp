@@ -0,0 +1,222 @@
+#include "include/pipeline/checkpoint.h"
+#include "include/log-writer/file_sync.h"
+#include <spdlog/spdlog.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace decode_clickhouse {
+
+bool Checkpoint::load(const std::string& path, Checkpoint& checkpoint) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    try {
+        nlohmann::json json = nlohmann::json::parse(file);
+        checkpoint = Checkpoint();
+        checkpoint.startBlock = json.at("start_block").get<uint64_t>();
+        checkpoint.endBlock = json.at("end_block").get<uint64_t>();
+        for (const auto& [name, position] : json.at("writers").items()) {
+            checkpoint.writers[name] = {position.at("block_number").get<uint64_t>(),
+                                        position.at("log_index").get<uint64_t>()};
+        }
+    } catch (const nlohmann::json::exception& e) {
+        throw std::runtime_error("Invalid checkpoint file " + path + ": " + e.what());
+    }
+    return true;
+}
+
+void Checkpoint::save(const std::string& path) const {
+    nlohmann::json writersJson = nlohmann::json::object();
+    for (const auto& [name, position] : writers) {
+        writersJson[name] = {{"block_number", position.blockNumber}, {"log_index", position.logIndex}};
+    }
+    nlohmann::json json = {{"start_block", startBlock}, {"end_block", endBlock}, {"writers", writersJson}};
+    std::string content = json.dump(2) + "\n";
+
+    // Synced before the rename, so after a crash the file holds either the old or the new checkpoint
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to create checkpoint: " + tempPath);
+    }
+
+    size_t offset = 0;
+    while (offset < content.size()) {
+        ssize_t written = ::write(fd, content.data() + offset, content.size() - offset);
+        if (written < 0) {
+            ::close(fd);
+            std::remove(tempPath.c_str());
+            throw std::runtime_error("Failed to write checkpoint: " + tempPath);
+        }
+        offset += static_cast<size_t>(written);
+    }
+
+    if (::fsync(fd) != 0) {
+        ::close(fd);
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("Failed to sync checkpoint: " + tempPath);
+    }
+    ::close(fd);
+
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("Failed to replace checkpoint: " + path);
+    }
+    syncDirectory(std::filesystem::path(path).parent_path().string());
+}
+
+CheckpointTracker::CheckpointTracker(const std::string& path, uint64_t startBlock, uint64_t endBlock,
+                                     const std::vector<std::string>& writerNames, const Checkpoint* resumeFrom)
+    : path_(path), writerNames_(writerNames), resumePositions_(writerNames.size()),
+      nextPage_(writerNames.size(), 0) {
+    checkpoint_.startBlock = startBlock;
+    checkpoint_.endBlock = endBlock;
+
+    if (resumeFrom) {
+        for (size_t i = 0; i < writerNames_.size(); ++i) {
+            auto it = resumeFrom->writers.find(writerNames_[i]);
+            if (it != resumeFrom->writers.end()) {
+                resumePositions_[i] = it->second;
+                checkpoint_.writers[it->first] = it->second;
+            }
+        }
+    }
+}
+
+std::optional<LogPosition> CheckpointTracker::resumePosition() const {
+    std::optional<LogPosition> position;
+    for (const auto& writerPosition : resumePositions_) {
+        if (!writerPosition) {
+            return std::nullopt;
+        }
+        if (!position || *writerPosition < *position) {
+            position = writerPosition;
+        }
+    }
+    return position;
+}
+
+std::optional<LogPosition> CheckpointTracker::writerResumePosition(size_t writerIndex) const {
+    return resumePositions_[writerIndex];
+}
+
+void CheckpointTracker::addPage(size_t pageNumber, const LogPosition& last) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pages_.empty()) {
+        // Every writer has completed all earlier pages
+        for (auto& next : nextPage_) {
+            next = pageNumber;
+        }
+    }
+
+    PageState page;
+    page.pageNumber = pageNumber;
+    page.last = last;
+    page.written.assign(writerNames_.size(), 0);
+    pages_.push_back(std::move(page));
+}
+
+void CheckpointTracker::pageDecoded(size_t pageNumber, size_t records) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (pages_.empty() || pageNumber < pages_.front().pageNumber) {
+            return;
+        }
+
+        PageState& page = pages_[pageNumber - pages_.front().pageNumber];
+        page.decoded = true;
+        page.records = records;
+
+        if (!advance()) {
+            return;
+        }
+        version_++;
+    }
+    save();
+}
+
+void CheckpointTracker::recordsWritten(size_t writerIndex, const std::vector<LogPosition>& positions) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& position : positions) {
+            // Pages cover consecutive position ranges, each up to its last log
+            auto it = std::lower_bound(pages_.begin(), pages_.end(), position,
+                                       [](const PageState& page, const LogPosition& value) {
+                                           return page.last < value;
+                                       });
+            if (it == pages_.end()) {
+                spdlog::debug("No checkpoint page for log at block {} index {}", position.blockNumber,
+                              position.logIndex);
+                continue;
+            }
+            it->written[writerIndex]++;
+        }
+
+        if (!advance()) {
+            return;
+        }
+        version_++;
+    }
+    save();
+}
+
+void CheckpointTracker::save() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (saving_) {
+        // The running save picks up the new version before it returns
+        return;
+    }
+
+    saving_ = true;
+    while (savedVersion_ < version_) {
+        Checkpoint checkpoint = checkpoint_;
+        const uint64_t version = version_;
+        lock.unlock();
+        try {
+            checkpoint.save(path_);
+        } catch (const std::exception& e) {
+            spdlog::warn("Failed to save checkpoint: {}", e.what());
+        }
+        lock.lock();
+        savedVersion_ = version;
+    }
+    saving_ = false;
+}
+
+bool CheckpointTracker::advance() {
+    if (pages_.empty()) {
+        return false;
+    }
+
+    const size_t firstPage = pages_.front().pageNumber;
+    bool moved = false;
+    for (size_t w = 0; w < writerNames_.size(); ++w) {
+        while (nextPage_[w] - firstPage < pages_.size()) {
+            const PageState& page = pages_[nextPage_[w] - firstPage];
+            if (!page.decoded || page.written[w] < page.records) {
+                break;
+            }
+            checkpoint_.writers[writerNames_[w]] = page.last;
+            nextPage_[w]++;
+            moved = true;
+        }
+    }
+
+    // Pages every writer has completed are no longer needed
+    while (!pages_.empty() &&
+           std::all_of(nextPage_.begin(), nextPage_.end(),
+                       [this](size_t next) { return next > pages_.front().pageNumber; })) {
+        pages_.pop_front();
+    }
+    return moved;
+}
+
+} // namespace decode_clickhouse
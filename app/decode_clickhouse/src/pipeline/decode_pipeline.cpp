@@ -0,0 +1,386 @@
+#include "include/pipeline/decode_pipeline.h"
+#include "../../../ethereum_decoder/include/json/json_decoder.h"
+#include <spdlog/spdlog.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+namespace decode_clickhouse {
+
+namespace {
+
+// Pages being decoded at once; each is a full page of logs
+constexpr size_t MAX_PAGES_IN_FLIGHT = 3;
+
+// Upper bound on the logs of one decode task
+constexpr size_t DECODE_CHUNK_SIZE = 512;
+
+// Records a decode worker collects before handing them to the writers
+constexpr size_t WRITE_BATCH_SIZE = 1024;
+
+// Batches waiting for each writer, per decode worker
+constexpr size_t WRITER_QUEUE_CAPACITY_PER_WORKER = 4;
+
+// View a log fetched in binary mode as a raw log entry; false if a topic is not 32 bytes
+bool toRawLogEntry(const LogRecord& log, ethereum_decoder::RawLogEntry& raw) {
+    raw.address = log.address;
+    raw.data = log.data;
+    raw.topicCount = 0;
+    for (std::string_view topic : {log.topic0, log.topic1, log.topic2, log.topic3}) {
+        if (topic.empty()) {
+            continue;
+        }
+        if (topic.size() != raw.topics[0].size()) {
+            return false;
+        }
+        std::memcpy(raw.topics[raw.topicCount++].data(), topic.data(), topic.size());
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+DecodePipeline::DecodePipeline(ClickHouseEthereum& ethereum, ContractABICache& abiCache,
+                               std::vector<std::unique_ptr<DatabaseWriter>>& writers, ProgressDisplay& progress,
+                               size_t numWorkers, CheckpointTracker* checkpoint)
+    : ethereum_(ethereum), abiCache_(abiCache), writers_(writers), progress_(progress),
+      numWorkers_(numWorkers > 0 ? numWorkers : 1), checkpoint_(checkpoint),
+      signatureRegistry_(ethereum_decoder::SignatureRegistry::global()),
+      registryDecoder_(nullptr, &signatureRegistry_),
+      workerBuffers_(numWorkers_),
+      pool_(numWorkers_) {
+    for (size_t i = 0; i < writers_.size(); ++i) {
+        writerQueues_.push_back(std::make_unique<MpscQueue<SharedBatch>>(
+            numWorkers_ * WRITER_QUEUE_CAPACITY_PER_WORKER));
+        keepDecodedParams_ = keepDecodedParams_ || writers_[i]->needsDecodedParams();
+    }
+}
+
+void DecodePipeline::run(uint64_t startBlock, uint64_t endBlock, const StreamOptions& options) {
+    running_ = true;
+    processedBlocks_ = std::make_unique<BlockCoverage>(startBlock, endBlock);
+
+    if (checkpoint_) {
+        for (size_t i = 0; i < writers_.size(); ++i) {
+            writers_[i]->setWrittenCallback([checkpoint = checkpoint_, i](const std::vector<LogPosition>& positions) {
+                checkpoint->recordsWritten(i, positions);
+            });
+        }
+    }
+
+    std::vector<std::thread> writerThreads;
+    for (size_t i = 0; i < writers_.size(); ++i) {
+        writerThreads.emplace_back(&DecodePipeline::writeWorker, this, i);
+    }
+    std::thread progressUpdater(&DecodePipeline::progressWorker, this);
+
+    // Fetch stage: runs here, the callback groups the page and hands its chunks to the pool.
+    // A failure is rethrown once the pages fetched so far are decoded and written
+    std::exception_ptr fetchError;
+    try {
+        ethereum_.streamLogs(startBlock, endBlock,
+                             [this](LogPage& pageResults, size_t pageNumber, size_t totalProcessed) {
+            spdlog::info("Processing page {} with {} logs (total fetched: {})", pageNumber, pageResults.size(),
+                         totalProcessed);
+
+            // A stopped writer would drop every further record, end the run so it can be resumed
+            for (const auto& writer : writers_) {
+                if (writer->hasFailed()) {
+                    throw std::runtime_error("the " + writer->getName() + " writer stopped after a write error");
+                }
+            }
+
+            currentPage_ = pageNumber;
+            submitPage(preparePage(pageResults, pageNumber));
+        }, options);
+    } catch (...) {
+        fetchError = std::current_exception();
+    }
+
+    // Drain the stages in order: decoders finish the submitted pages, then the writers their batches
+    pool_.wait();
+    for (auto& buffer : workerBuffers_) {
+        if (!buffer.records.empty()) {
+            handOff(buffer.records);
+        }
+    }
+    for (auto& queue : writerQueues_) {
+        queue->close();
+    }
+    for (auto& thread : writerThreads) {
+        thread.join();
+    }
+
+    running_ = false;
+    progressUpdater.join();
+
+    progress_.updateProgress(currentPage_.load(), processedLogs_.load(), decodedLogs_.load(), getProcessedBlocks());
+
+    if (fetchError) {
+        std::rethrow_exception(fetchError);
+    }
+}
+
+size_t DecodePipeline::getProcessedBlocks() const {
+    return processedBlocks_ ? processedBlocks_->count() : 0;
+}
+
+std::shared_ptr<DecodePipeline::Page> DecodePipeline::preparePage(LogPage& pageResults, size_t pageNumber) {
+    auto page = std::make_shared<Page>();
+    page->pageNumber = pageNumber;
+    page->logs = std::move(pageResults);
+
+    if (checkpoint_ && !page->logs.empty()) {
+        checkpoint_->addPage(pageNumber, {page->logs.back().blockNumber, page->logs.back().logIndex});
+    }
+
+    // Track unique blocks in this page; its logs are in block order, so each block is added once
+    const LogRecord* previous = nullptr;
+    for (const auto& log : page->logs) {
+        if (!previous || log.blockNumber != previous->blockNumber) {
+            processedBlocks_->add(log.blockNumber);
+        }
+        previous = &log;
+    }
+
+    // Only the first log of each contract copies its address
+    for (const auto& log : page->logs) {
+        auto it = page->logsByContract.find(log.address);
+        if (it == page->logsByContract.end()) {
+            it = page->logsByContract.emplace(std::string(log.address), std::vector<const LogRecord*>()).first;
+        }
+        it->second.push_back(&log);
+    }
+
+    // Resolve decoders for all contracts in this page batch, fetching only uncached ABIs
+    std::vector<std::string> contractAddresses;
+    contractAddresses.reserve(page->logsByContract.size());
+    for (const auto& [address, logs] : page->logsByContract) {
+        contractAddresses.push_back(address);
+    }
+
+    page->decoders = abiCache_.resolve(contractAddresses, ethereum_);
+    spdlog::debug("Resolved ABIs for {} out of {} contracts (cache: {} entries, {} hits, {} misses)",
+                  page->decoders.size(), contractAddresses.size(), abiCache_.size(),
+                  abiCache_.getHits(), abiCache_.getMisses());
+
+    return page;
+}
+
+void DecodePipeline::submitPage(const std::shared_ptr<Page>& page) {
+    std::vector<WorkStealingPool::Task> tasks;
+    for (const auto& [address, logs] : page->logsByContract) {
+        for (size_t offset = 0; offset < logs.size(); offset += DECODE_CHUNK_SIZE) {
+            DecodeTask task;
+            task.page = page;
+            task.address = &address;
+            task.logs = logs.data() + offset;
+            task.count = std::min(DECODE_CHUNK_SIZE, logs.size() - offset);
+            task.firstChunk = offset == 0;
+            tasks.push_back([this, task]() { runTask(task); });
+        }
+    }
+    if (tasks.empty()) {
+        return;
+    }
+
+    // Backpressure on the fetch stage: at most a few pages are held for decoding
+    {
+        std::unique_lock<std::mutex> lock(pagesMutex_);
+        pagesCondition_.wait(lock, [this] { return pagesInFlight_ < MAX_PAGES_IN_FLIGHT; });
+        pagesInFlight_++;
+    }
+
+    page->remainingTasks = tasks.size();
+    pool_.submitAll(std::move(tasks));
+}
+
+void DecodePipeline::runTask(const DecodeTask& task) {
+    RecordBatch& records = workerBuffers_[pool_.currentWorker()].records;
+    decodeTask(task, records);
+    if (records.size() >= WRITE_BATCH_SIZE) {
+        handOff(records);
+    }
+    finishTask(*task.page);
+}
+
+void DecodePipeline::handOff(RecordBatch& records) {
+    auto batch = std::make_shared<const RecordBatch>(std::move(records));
+    records = RecordBatch();
+    records.reserve(WRITE_BATCH_SIZE);
+
+    for (auto& queue : writerQueues_) {
+        queue->push(batch);
+    }
+}
+
+void DecodePipeline::decodeTask(const DecodeTask& task, RecordBatch& records) {
+    const std::string& contractAddress = *task.address;
+    Page& page = *task.page;
+
+    // Check if we have ABI for this contract
+    auto decoderIt = page.decoders.find(contractAddress);
+    bool hasABI = decoderIt != page.decoders.end();
+    if (!hasABI && task.firstChunk) {
+        spdlog::debug("No ABI found for contract {}, decoding {} logs from known signatures",
+                      contractAddress, page.logsByContract.at(contractAddress).size());
+    }
+
+    size_t processed = 0;
+    size_t decoded = 0;
+
+    try {
+        ethereum_decoder::EthereumDecoder& decoder = hasABI ? *decoderIt->second : registryDecoder_;
+        ethereum_decoder::JsonDecoder jsonDecoder;
+
+        for (size_t i = 0; i < task.count; ++i) {
+            const LogRecord* logPtr = task.logs[i];
+            processed++;
+
+            try {
+                std::unique_ptr<ethereum_decoder::DecodedLog> decodedLog;
+                if (logPtr->binary) {
+                    ethereum_decoder::RawLogEntry rawLog;
+                    if (!toRawLogEntry(*logPtr, rawLog)) {
+                        spdlog::debug("Malformed topic in log at block {} index {}", logPtr->blockNumber,
+                                      logPtr->logIndex);
+                        continue;
+                    }
+
+                    // Without an ABI only logs matching a registered signature are decoded
+                    if (!hasABI && (rawLog.topicCount == 0 ||
+                                    !signatureRegistry_.find(rawLog.topics[0], rawLog.topicCount - 1))) {
+                        continue;
+                    }
+                    decodedLog = decoder.decodeLog(rawLog);
+                } else {
+                    ethereum_decoder::LogEntry logEntry;
+                    logEntry.address = std::string(logPtr->address);
+                    for (std::string_view topic : {logPtr->topic0, logPtr->topic1, logPtr->topic2, logPtr->topic3}) {
+                        if (!topic.empty()) {
+                            logEntry.topics.emplace_back(topic);
+                        }
+                    }
+                    logEntry.data = std::string(logPtr->data);
+
+                    if (!hasABI && (logEntry.topics.empty() ||
+                                    !signatureRegistry_.find(logEntry.topics[0], logEntry.topics.size() - 1))) {
+                        continue;
+                    }
+
+                    auto decodedLogs = decoder.decodeLogs({logEntry});
+                    if (decodedLogs.empty()) {
+                        spdlog::debug("Decoder returned empty result for log at block {} index {}",
+                                      logPtr->blockNumber, logPtr->logIndex);
+                        continue;
+                    }
+                    decodedLog = std::move(decodedLogs[0]);
+                }
+
+                ethereum_decoder::DecodedLogRecord decodedLogRecord;
+                decodedLogRecord.transactionHash = std::string(logPtr->transactionHash);
+                decodedLogRecord.blockNumber = logPtr->blockNumber;
+                decodedLogRecord.logIndex = logPtr->logIndex;
+                decodedLogRecord.contractAddress = contractAddress;
+                decodedLogRecord.eventName = decodedLog->eventName;
+                decodedLogRecord.eventSignature = decodedLog->eventSignature;
+
+                try {
+                    auto jsonResult = jsonDecoder.decodedLogToJson(*decodedLog);
+                    decodedLogRecord.args = jsonResult.dump();
+                } catch (const std::exception& json_e) {
+                    // Built as JSON too, writers embed args as is
+                    decodedLogRecord.args =
+                        nlohmann::json{{"error", "JSON conversion failed: " + std::string(json_e.what())}}.dump();
+                }
+                if (keepDecodedParams_) {
+                    decodedLogRecord.params =
+                        std::make_shared<const std::vector<ethereum_decoder::DecodedParam>>(std::move(decodedLog->params));
+                }
+
+                records.push_back(std::move(decodedLogRecord));
+                decoded++;
+            } catch (const std::exception& e) {
+                // Log decoding error for debugging
+                spdlog::debug("Failed to decode log: {}", e.what());
+                continue;
+            }
+        }
+    } catch (const std::exception& e) {
+        spdlog::error("Failed to decode logs for contract {}: {}", contractAddress, e.what());
+        processed = task.count;
+    }
+
+    page.processed += processed;
+    page.decoded += decoded;
+    processedLogs_ += processed;
+    decodedLogs_ += decoded;
+}
+
+void DecodePipeline::finishTask(Page& page) {
+    if (--page.remainingTasks > 0) {
+        return;
+    }
+
+    size_t processed = page.processed.load();
+    size_t decoded = page.decoded.load();
+    float decodeRate = processed > 0 ? (static_cast<float>(decoded) / processed * 100.0f) : 0.0f;
+    spdlog::info("  ✓ Page {}: processed {} logs, decoded {} ({:.1f}% success rate)",
+                 page.pageNumber, processed, decoded, decodeRate);
+
+    if (checkpoint_) {
+        checkpoint_->pageDecoded(page.pageNumber, decoded);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pagesMutex_);
+        pagesInFlight_--;
+    }
+    pagesCondition_.notify_one();
+}
+
+void DecodePipeline::writeWorker(size_t writerIndex) {
+    DatabaseWriter& writer = *writers_[writerIndex];
+    std::optional<LogPosition> resumeFrom;
+    if (checkpoint_) {
+        resumeFrom = checkpoint_->writerResumePosition(writerIndex);
+    }
+
+    SharedBatch batch;
+    while (writerQueues_[writerIndex]->pop(batch)) {
+        auto written = [&resumeFrom](const ethereum_decoder::DecodedLogRecord& record) {
+            return LogPosition{record.blockNumber, record.logIndex} <= *resumeFrom;
+        };
+        if (resumeFrom && std::any_of(batch->begin(), batch->end(), written)) {
+            // This writer is ahead of the resumed fetch: only pass on what it has not written yet
+            RecordBatch fresh;
+            std::vector<LogPosition> skipped;
+            for (const auto& record : *batch) {
+                if (written(record)) {
+                    skipped.push_back({record.blockNumber, record.logIndex});
+                } else {
+                    fresh.push_back(record);
+                }
+            }
+            checkpoint_->recordsWritten(writerIndex, skipped);
+            writer.write(fresh);
+        } else {
+            writer.write(*batch);
+        }
+        batch.reset();
+    }
+}
+
+void DecodePipeline::progressWorker() {
+    progress_.setStatus("Decoding");
+    while (running_) {
+        progress_.updateProgress(currentPage_.load(), processedLogs_.load(), decodedLogs_.load(),
+                                 getProcessedBlocks(), pool_.getActiveWorkers());
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+} // namespace decode_clickhouse
@@ -0,0 +1,135 @@
+#include "include/pipeline/work_stealing_pool.h"
+#include <spdlog/spdlog.h>
+
+namespace decode_clickhouse {
+
+namespace {
+
+// Lets submit() find the deque of the worker it is called from
+thread_local const WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentWorkerIndex = 0;
+
+} // anonymous namespace
+
+WorkStealingPool::WorkStealingPool(size_t numWorkers) {
+    if (numWorkers == 0) {
+        numWorkers = 1;
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < numWorkers; ++i) {
+        threads_.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    wait();
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wakeCondition_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    size_t index = currentPool == this ? currentWorkerIndex : nextQueue_++ % queues_.size();
+    push(index, std::move(task));
+}
+
+void WorkStealingPool::submitAll(std::vector<Task> tasks) {
+    size_t start = nextQueue_.fetch_add(tasks.size());
+    for (size_t i = 0; i < tasks.size(); ++i) {
+        push((start + i) % queues_.size(), std::move(tasks[i]));
+    }
+}
+
+size_t WorkStealingPool::currentWorker() const {
+    return currentPool == this ? currentWorkerIndex : queues_.size();
+}
+
+void WorkStealingPool::wait() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    idleCondition_.wait(lock, [this] { return pending_.load() == 0; });
+}
+
+void WorkStealingPool::push(size_t index, Task task) {
+    // Counted before it is visible, so a worker that takes it never sees the counters underflow
+    pending_++;
+    queued_++;
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+
+    // A worker about to sleep registers in sleepers_ before re-checking queued_,
+    // so either it sees this task or we see it and wake it up
+    if (sleepers_.load() > 0) {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wakeCondition_.notify_one();
+    }
+}
+
+bool WorkStealingPool::popOwn(size_t index, Task& task) {
+    WorkerQueue& queue = *queues_[index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t index, Task& task) {
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            // Oldest task, the one its owner would get to last
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorkerIndex = index;
+
+    while (true) {
+        Task task;
+        if (popOwn(index, task) || steal(index, task)) {
+            queued_--;
+            active_++;
+            try {
+                task();
+            } catch (const std::exception& e) {
+                spdlog::error("Worker task failed: {}", e.what());
+            }
+            active_--;
+
+            if (--pending_ == 0) {
+                std::lock_guard<std::mutex> lock(wakeMutex_);
+                idleCondition_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex_);
+        sleepers_++;
+        wakeCondition_.wait(lock, [this] { return stopping_ || queued_.load() > 0; });
+        sleepers_--;
+        if (stopping_ && queued_.load() == 0) {
+            break;
+        }
+    }
+}
+
+} // namespace decode_clickhouse
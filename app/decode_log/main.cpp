@@ -1,6 +1,7 @@
 #include "decoding/abi_parser.h"
 #include "ethereum_decoder.h"
 #include "types.h"
+#include "utils.h"
 #include "json/json_decoder.h"
 #include "decoding/log_data.h"
 #include "src/decode_log_arg_parser.h"
@@ -37,6 +38,12 @@ void printDecodedLog(const ethereum_decoder::DecodedLog &log) {
                     std::cout << std::hex << std::setw(2) << std::setfill('0')
                             << static_cast<int>(byte);
                 }
+            } else if constexpr (std::is_same_v<T, ethereum_decoder::UInt256> ||
+                                 std::is_same_v<T, ethereum_decoder::Int256>) {
+                std::cout << value.toDecimal();
+            } else if constexpr (std::is_same_v<T, ethereum_decoder::AddressBytes> ||
+                                 std::is_same_v<T, ethereum_decoder::Bytes32>) {
+                std::cout << "0x" << ethereum_decoder::Utils::bytesToHex(value.data(), value.size());
             } else if constexpr (std::is_same_v<T, std::vector<std::string> >) {
                 std::cout << "[";
                 for (size_t i = 0; i < value.size(); i++) {
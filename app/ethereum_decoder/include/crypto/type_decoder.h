@@ -2,49 +2,94 @@
 #define ETHEREUM_DECODER_TYPE_DECODER_H
 
 #include "types.h"
+#include "decoding/decode_plan.h"
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace ethereum_decoder {
 
 class TypeDecoder {
 public:
-    // Decode a single value from hex data
+    // ABI-encoded data is laid out in 32-byte words
+    static constexpr size_t WORD_SIZE = 32;
+
+    // Decode a single value from hex data (offset is in hex characters)
     static DecodedValue decodeValue(
         const std::string& type,
         const std::string& hexData,
         size_t& offset
     );
-    
+
     // Decode multiple values from hex data
     static std::vector<DecodedValue> decodeValues(
         const std::vector<std::string>& types,
         const std::string& hexData
     );
 
+    // Decode a single value from raw ABI-encoded bytes (offset is in bytes)
+    static DecodedValue decodeValue(
+        const std::string& type,
+        const uint8_t* data,
+        size_t length,
+        size_t& offset
+    );
+
+    // Decode multiple values from raw ABI-encoded bytes
+    static std::vector<DecodedValue> decodeValues(
+        const std::vector<std::string>& types,
+        const uint8_t* data,
+        size_t length
+    );
+
+    // Decode a value described by a compiled type plan. headOffset is advanced past the
+    // value's head slot; dynamic values are resolved relative to base
+    static DecodedValue decodeValue(
+        const ABITypePlan& type,
+        const uint8_t* data,
+        size_t length,
+        size_t& headOffset,
+        size_t base = 0
+    );
+
+    // Decode the non-indexed parameters of an event from its raw data
+    static std::vector<DecodedValue> decodeParams(
+        const std::vector<ParamPlan>& params,
+        const uint8_t* data,
+        size_t length
+    );
+
+    // Render a decoded value as text; typed numbers and byte arrays are formatted here on demand
+    static std::string formatValue(const DecodedValue& value);
+
 private:
-    // Type-specific decoders
-    static std::string decodeAddress(const std::string& hexData, size_t& offset);
-    static std::string decodeUint256(const std::string& hexData, size_t& offset);
-    static std::string decodeInt256(const std::string& hexData, size_t& offset);
-    static bool decodeBool(const std::string& hexData, size_t& offset);
-    static std::vector<uint8_t> decodeBytes(const std::string& hexData, size_t& offset, size_t length = 0);
-    static std::string decodeString(const std::string& hexData, size_t& offset);
-    static std::vector<DecodedValue> decodeArray(
-        const std::string& elementType,
-        const std::string& hexData,
+    // Decode the content of a compiled type starting at pos
+    static DecodedValue decodeContent(const ABITypePlan& type, const uint8_t* data, size_t length, size_t pos);
+
+    // Type-specific decoders, all operating on raw bytes
+    static AddressBytes decodeAddress(const uint8_t* data, size_t length, size_t& offset);
+    static UInt256 decodeUint256(const uint8_t* data, size_t length, size_t& offset);
+    static Int256 decodeInt256(const uint8_t* data, size_t length, size_t& offset);
+    static Bytes32 decodeBytes32(const uint8_t* data, size_t length, size_t& offset);
+    static bool decodeBool(const uint8_t* data, size_t length, size_t& offset);
+    static std::vector<uint8_t> decodeBytes(const uint8_t* data, size_t length, size_t& offset, size_t size = 0);
+    static std::string decodeString(const uint8_t* data, size_t length, size_t& offset);
+    static std::vector<std::string> decodeArray(
+        std::string_view elementType,
+        const uint8_t* data,
+        size_t length,
         size_t& offset,
-        size_t length = 0
+        size_t arrayLength
     );
-    
+
+    // Dispatch a type string through the allocation-free type parser
+    static DecodedValue decodeTypeString(std::string_view type, const uint8_t* data, size_t length, size_t& offset);
+
     // Helper functions
-    static std::string readBytes32(const std::string& hexData, size_t& offset);
-    static uint64_t hexToUint64(const std::string& hex);
-    static std::string removeHexPrefix(const std::string& hex);
-    static bool isDynamicType(const std::string& type);
-    static std::pair<std::string, size_t> parseArrayType(const std::string& type);
+    static const uint8_t* readWord(const uint8_t* data, size_t length, size_t& offset);
+    static size_t readSize(const uint8_t* data, size_t length, size_t& offset);
 };
 
 } // namespace ethereum_decoder
 
-#endif // ETHEREUM_DECODER_TYPE_DECODER_H
\ No newline at end of file
+#endif // ETHEREUM_DECODER_TYPE_DECODER_H
@@ -0,0 +1,74 @@
+#ifndef ETHEREUM_DECODER_ABI_SNAPSHOT_H
+#define ETHEREUM_DECODER_ABI_SNAPSHOT_H
+
+#include "types.h"
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ethereum_decoder {
+
+// Read-only, memory-mapped snapshot of contract ABIs.
+//
+// Layout (all integers little-endian):
+//   header:  "EDABISNP" | u32 version | u32 contract count | u64 index offset
+//   records: per contract: name, then events with precomputed signatures and inputs
+//   index:   per contract, sorted by address: 20-byte address | u32 record length | u64 record offset
+//
+// Opening only maps the file; a contract's record is decoded when it is loaded, so startup
+// cost does not depend on the snapshot size. Decode plans are recompiled from the stored types.
+class ABISnapshot {
+public:
+    static constexpr uint32_t VERSION = 1;
+
+    // Throws std::runtime_error if the file cannot be mapped or is not a valid snapshot
+    static std::unique_ptr<ABISnapshot> open(const std::string& path);
+
+    ~ABISnapshot();
+    ABISnapshot(const ABISnapshot&) = delete;
+    ABISnapshot& operator=(const ABISnapshot&) = delete;
+
+    size_t size() const { return count_; }
+
+    bool contains(const std::string& address) const;
+
+    // Rebuild the ABI stored for a contract, returns nullptr if the contract is not in the snapshot
+    std::unique_ptr<ABI> load(const std::string& address, std::string* name = nullptr) const;
+
+private:
+    friend class ABISnapshotWriter;
+
+    ABISnapshot() = default;
+
+    // Raw record bytes for an address, or false if it is not in the snapshot
+    bool findRecord(const AddressBytes& address, const uint8_t*& record, size_t& length) const;
+
+    const uint8_t* data_ = nullptr;
+    size_t length_ = 0;
+    size_t count_ = 0;
+    const uint8_t* index_ = nullptr;
+};
+
+// Builds snapshot files, either from scratch or by extending an existing snapshot
+class ABISnapshotWriter {
+public:
+    // Add or replace a contract; throws std::runtime_error for malformed addresses
+    void add(const std::string& address, const std::string& name, const ABI& abi);
+
+    // Copy every contract of an existing snapshot that has not been added yet
+    void addAll(const ABISnapshot& snapshot);
+
+    size_t size() const { return records_.size(); }
+
+    // Write to a temporary file next to path and rename it into place
+    void write(const std::string& path) const;
+
+private:
+    std::map<AddressBytes, std::string> records_;
+};
+
+} // namespace ethereum_decoder
+
+#endif // ETHEREUM_DECODER_ABI_SNAPSHOT_H
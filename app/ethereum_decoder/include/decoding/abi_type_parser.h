@@ -0,0 +1,37 @@
+#ifndef ETHEREUM_DECODER_ABI_TYPE_PARSER_H
+#define ETHEREUM_DECODER_ABI_TYPE_PARSER_H
+
+#include "decoding/decode_plan.h"
+#include <string_view>
+
+namespace ethereum_decoder {
+
+// Outermost layer of a parsed ABI type string; views point into the parsed string
+struct ABITypeInfo {
+    ABIOpcode opcode = ABIOpcode::Uint;
+    size_t size = 0;              // Bit width for uint/int, byte length for bytesN
+    size_t arrayLength = 0;       // Element count for fixed arrays
+    std::string_view inner;       // Array element type or tuple component list
+};
+
+// Hand-written ABI type string parser, never allocates
+class ABITypeParser {
+public:
+    // Parse the outermost layer of a type (uintN, intN, bytesN, T[], T[k], (T1,T2), tuple...)
+    // Returns false for unsupported types
+    static bool parse(std::string_view type, ABITypeInfo& info);
+
+    // Split the next top-level component off a tuple component list such as "uint256,(bool,bytes)[]"
+    // Returns false once the list is exhausted
+    static bool nextComponent(std::string_view& components, std::string_view& component);
+
+    // Whether a type is encoded out-of-line (bytes, string, T[], and anything containing them)
+    static bool isDynamic(std::string_view type);
+
+private:
+    static bool parseNumber(std::string_view digits, size_t maxDigits, size_t& value);
+};
+
+} // namespace ethereum_decoder
+
+#endif // ETHEREUM_DECODER_ABI_TYPE_PARSER_H
@@ -0,0 +1,62 @@
+#ifndef ETHEREUM_DECODER_DECODE_PLAN_H
+#define ETHEREUM_DECODER_DECODE_PLAN_H
+
+#include "types.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ethereum_decoder {
+
+// Opcodes of a compiled ABI type
+enum class ABIOpcode : uint8_t {
+    Address,
+    Uint,
+    Int,
+    Bool,
+    FixedBytes,
+    Bytes,
+    String,
+    DynamicArray,
+    FixedArray,
+    Tuple
+};
+
+// Compiled form of a single ABI type, resolved once at ABI-load time
+struct ABITypePlan {
+    ABIOpcode opcode = ABIOpcode::Uint;
+    size_t size = 0;          // Bit width for uint/int, byte length for bytesN
+    size_t arrayLength = 0;   // Element count for fixed arrays
+    bool dynamic = false;     // Encoded out-of-line behind an offset word
+    size_t headSize = 32;     // Bytes occupied in the enclosing head
+    std::vector<ABITypePlan> children;         // Array element or tuple components
+    std::vector<std::string> componentNames;   // Tuple component names
+};
+
+// A single event parameter together with its position in ABIEvent::inputs
+struct ParamPlan {
+    size_t inputIndex = 0;
+    ABITypePlan type;
+};
+
+// Decode plan for an event: indexed params in topic order, the rest in data head order
+struct EventDecodePlan {
+    std::vector<ParamPlan> topicParams;
+    std::vector<ParamPlan> dataParams;
+    size_t dataHeadSize = 0;
+};
+
+class DecodePlanCompiler {
+public:
+    // Compile all parameters of an event, throws on unsupported types
+    static std::shared_ptr<const EventDecodePlan> compile(const ABIEvent& event);
+
+    // Compile a single parameter type (including tuple components)
+    static ABITypePlan compileType(std::string_view type, const std::vector<ABIInput>& components = {});
+};
+
+} // namespace ethereum_decoder
+
+#endif // ETHEREUM_DECODER_DECODE_PLAN_H
@@ -0,0 +1,42 @@
+#ifndef ETHEREUM_DECODER_EVENT_LOOKUP_TABLE_H
+#define ETHEREUM_DECODER_EVENT_LOOKUP_TABLE_H
+
+#include "types.h"
+#include <string>
+#include <vector>
+
+namespace ethereum_decoder {
+
+// Open-addressing hash table from a raw 32-byte topic0 to its ABI event
+class EventLookupTable {
+public:
+    // Insert or replace the event for a topic; the event must outlive the table
+    void insert(const Bytes32& topic, const ABIEvent* event);
+
+    // Returns nullptr if the topic is unknown
+    const ABIEvent* find(const Bytes32& topic) const;
+
+    size_t size() const { return size_; }
+
+    // Canonicalise a hex topic (with or without 0x, any case) into raw bytes
+    // Returns false if it is not a 32-byte hex string
+    static bool parseTopic(const std::string& hex, Bytes32& topic);
+
+private:
+    struct Slot {
+        Bytes32 topic;
+        const ABIEvent* event = nullptr;  // nullptr marks an empty slot
+    };
+
+    // Topics are keccak hashes, so their leading bytes are already uniformly distributed
+    static size_t hashTopic(const Bytes32& topic);
+
+    void grow();
+
+    std::vector<Slot> slots_;
+    size_t size_ = 0;
+};
+
+} // namespace ethereum_decoder
+
+#endif // ETHEREUM_DECODER_EVENT_LOOKUP_TABLE_H
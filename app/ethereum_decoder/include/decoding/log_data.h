@@ -9,6 +9,9 @@ namespace ethereum_decoder {
 class LogData {
 public:
     static LogEntry parse(const std::string& logData);
+
+    // Hex form of a raw log, as kept in DecodedLog::rawLog
+    static LogEntry toLogEntry(const RawLogEntry& log);
 };
 
 } // namespace ethereum_decoder
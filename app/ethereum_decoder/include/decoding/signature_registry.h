@@ -0,0 +1,40 @@
+#ifndef ETHEREUM_DECODER_SIGNATURE_REGISTRY_H
+#define ETHEREUM_DECODER_SIGNATURE_REGISTRY_H
+
+#include "types.h"
+#include "decoding/event_lookup_table.h"
+#include <deque>
+#include <shared_mutex>
+#include <string>
+
+namespace ethereum_decoder {
+
+// Process-wide registry of known events keyed by topic0 and indexed parameter count.
+// The indexed count disambiguates events sharing a signature, e.g. ERC-20 Transfer
+// (two indexed params) and ERC-721 Transfer (three). Safe for concurrent use.
+class SignatureRegistry {
+public:
+    // Registry shared by all decoders in the process
+    static SignatureRegistry& global();
+
+    // Add every non-anonymous event of an ABI that is not known yet, returns how many were added
+    size_t registerABI(const ABI& abi);
+
+    // Returns nullptr if no event matches; returned events stay valid for the registry lifetime
+    const ABIEvent* find(const Bytes32& topic0, size_t indexedCount) const;
+    const ABIEvent* find(const std::string& topic0, size_t indexedCount) const;
+
+    size_t size() const;
+
+private:
+    // Non-anonymous events have at most three indexed parameters
+    static constexpr size_t MAX_INDEXED = 3;
+
+    mutable std::shared_mutex mutex_;
+    std::deque<ABIEvent> events_;  // Deque keeps event addresses stable as it grows
+    EventLookupTable tables_[MAX_INDEXED + 1];
+};
+
+} // namespace ethereum_decoder
+
+#endif // ETHEREUM_DECODER_SIGNATURE_REGISTRY_H
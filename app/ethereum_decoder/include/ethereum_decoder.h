@@ -2,38 +2,64 @@
 #define ETHEREUM_DECODER_ETHEREUM_DECODER_H
 
 #include "types.h"
+#include "decoding/decode_plan.h"
+#include "decoding/event_lookup_table.h"
+#include "decoding/signature_registry.h"
 #include <memory>
+#include <optional>
 
 namespace ethereum_decoder {
 
 class EthereumDecoder {
 public:
-    EthereumDecoder(std::unique_ptr<ABI> abi);
+    // Events missing from the contract ABI are looked up in the registry, if one is given
+    EthereumDecoder(std::unique_ptr<ABI> abi, const SignatureRegistry* registry = nullptr);
     ~EthereumDecoder() = default;
 
     // Decode a single log entry
     std::unique_ptr<DecodedLog> decodeLog(const LogEntry& log);
+
+    // Decode a log given as raw bytes, no hex is parsed. Only logs of unknown events
+    // go through the hex form, which their fallback output is built from
+    std::unique_ptr<DecodedLog> decodeLog(const RawLogEntry& log);
     
     // Decode multiple log entries
     std::vector<std::unique_ptr<DecodedLog>> decodeLogs(const std::vector<LogEntry>& logs);
 
 private:
     std::unique_ptr<ABI> abi_;
+    EventLookupTable eventsByTopic_;  // Points into abi_->eventsBySignature
+    const SignatureRegistry* registry_;
     
-    // Decode indexed parameters from topics
-    std::vector<DecodedParam> decodeTopics(
-        const std::vector<Hash>& topics,
-        const std::vector<ABIInput>& inputs
+    // Decode the parameters of a known event from raw topics (topic0 included) and data
+    std::unique_ptr<DecodedLog> decodeEvent(
+        const ABIEvent& event,
+        const EventDecodePlan& plan,
+        const Bytes32* topics,
+        size_t topicCount,
+        const uint8_t* data,
+        size_t dataLength
+    );
+
+    // Decode indexed parameters from topics into their input slots
+    void decodeTopics(
+        const Bytes32* topics,
+        size_t topicCount,
+        const EventDecodePlan& plan,
+        std::vector<std::optional<DecodedValue>>& values
     );
     
-    // Decode non-indexed parameters from data
-    std::vector<DecodedParam> decodeData(
-        const std::string& data,
-        const std::vector<ABIInput>& inputs
+    // Decode non-indexed parameters from data into their input slots
+    void decodeData(
+        const uint8_t* data,
+        size_t dataLength,
+        const EventDecodePlan& plan,
+        std::vector<std::optional<DecodedValue>>& values
     );
     
-    // Find matching event in ABI
-    const ABIEvent* findEvent(const std::string& signature);
+    // Find matching event by topic0, falling back to the registry
+    const ABIEvent* findEvent(const LogEntry& log);
+    const ABIEvent* findEvent(const Bytes32& topic0, size_t topicCount);
 };
 
 } // namespace ethereum_decoder
@@ -1,7 +1,10 @@
 #ifndef ETHEREUM_DECODER_TYPES_H
 #define ETHEREUM_DECODER_TYPES_H
 
+#include "uint256.h"
+#include <array>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <variant>
 #include <map>
@@ -13,6 +16,12 @@ using Bytes = std::vector<uint8_t>;
 using Hash = std::string;
 using Address = std::string;
 
+// Raw forms of fixed-size ABI values, formatted to hex only when text is needed
+using AddressBytes = std::array<uint8_t, 20>;
+using Bytes32 = std::array<uint8_t, 32>;
+
+struct EventDecodePlan;
+
 struct ABIInput {
     std::string name;
     std::string type;
@@ -25,6 +34,7 @@ struct ABIEvent {
     std::vector<ABIInput> inputs;
     bool anonymous = false;
     std::string signature;  // Will be computed
+    std::shared_ptr<const EventDecodePlan> decodePlan;  // Compiled at ABI-load time
 };
 
 struct ABI {
@@ -38,6 +48,15 @@ struct LogEntry {
     std::string data;  // Hex string
 };
 
+// A log as raw bytes, e.g. fetched with unhex() instead of as hex text.
+// address and data are views into storage that must outlive decoding
+struct RawLogEntry {
+    std::string_view address;  // Hex string
+    std::array<Bytes32, 4> topics;
+    size_t topicCount = 0;
+    std::string_view data;  // Raw ABI-encoded bytes
+};
+
 using DecodedValue = std::variant<
     std::string,
     uint64_t,
@@ -45,13 +64,18 @@ using DecodedValue = std::variant<
     bool,
     std::vector<uint8_t>,
     std::vector<std::string>,
-    std::map<std::string, std::string>
+    std::map<std::string, std::string>,
+    UInt256,        // uintN
+    Int256,         // intN
+    AddressBytes,   // address
+    Bytes32         // bytes32
 >;
 
 struct DecodedParam {
     std::string name;
     std::string type;
     DecodedValue value;
+    bool indexed = false;  // Indexed dynamic, array and tuple values hold their topic hash as hex
 };
 
 struct DecodedLog {
@@ -70,6 +94,8 @@ struct DecodedLogRecord {
     std::string eventSignature;
     std::string signature;
     std::string args;
+    // Typed parameters, only kept when a writer asks for them
+    std::shared_ptr<const std::vector<DecodedParam>> params;
 };
 
 } // namespace ethereum_decoder
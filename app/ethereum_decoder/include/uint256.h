@@ -0,0 +1,63 @@
+#ifndef ETHEREUM_DECODER_UINT256_H
+#define ETHEREUM_DECODER_UINT256_H
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+
+namespace ethereum_decoder {
+
+// Fixed-width 256-bit unsigned integer stored as four 64-bit limbs (least significant first)
+class UInt256 {
+public:
+    static constexpr size_t BYTES = 32;
+
+    UInt256() : limbs_{0, 0, 0, 0} {}
+
+    // Load from up to 32 big-endian bytes, shorter inputs are zero-extended
+    static UInt256 fromBigEndian(const uint8_t* bytes, size_t length);
+
+    // Parse unsigned decimal digits, throws on other characters or values above 2^256 - 1
+    static UInt256 fromDecimal(std::string_view digits);
+
+    // Store as 32 big-endian bytes
+    void toBigEndian(uint8_t* bytes) const;
+
+    // Low 64 bits, the whole value for uint64 and below
+    uint64_t low64() const { return limbs_[0]; }
+
+    // Whether the top bit is set, i.e. the value is negative as a two's-complement int256
+    bool isNegative() const { return (limbs_[3] >> 63) != 0; }
+
+    bool isZero() const { return (limbs_[0] | limbs_[1] | limbs_[2] | limbs_[3]) == 0; }
+
+    // Two's-complement negation modulo 2^256
+    UInt256 negate() const;
+
+    // Divide in place by a 64-bit divisor, returning the remainder
+    uint64_t divideBy(uint64_t divisor);
+
+    // Decimal representation of the unsigned value
+    std::string toDecimal() const;
+
+    // Decimal representation of the value read as a two's-complement int256
+    std::string toSignedDecimal() const;
+
+private:
+    static std::string formatDecimal(UInt256 value, bool negative);
+
+    uint64_t limbs_[4];
+};
+
+// Signed 256-bit integer, kept in two's-complement form until it is formatted
+struct Int256 {
+    UInt256 bits;
+
+    bool isNegative() const { return bits.isNegative(); }
+    std::string toDecimal() const { return bits.toSignedDecimal(); }
+};
+
+} // namespace ethereum_decoder
+
+#endif // ETHEREUM_DECODER_UINT256_H
@@ -3,6 +3,7 @@
 
 #include <string>
 #include <vector>
+#include <cstdint>
 
 namespace ethereum_decoder {
 
@@ -11,8 +12,12 @@ public:
     // Convert hex string to bytes
     static std::vector<uint8_t> hexToBytes(const std::string& hex);
     
+    // Convert hex string into a caller-provided buffer of exactly outLength bytes
+    static void hexToBytes(const std::string& hex, uint8_t* out, size_t outLength);
+    
     // Convert bytes to hex string
     static std::string bytesToHex(const std::vector<uint8_t>& bytes);
+    static std::string bytesToHex(const uint8_t* bytes, size_t length);
     
     // Remove 0x prefix if present
     static std::string removeHexPrefix(const std::string& hex);
@@ -27,6 +32,9 @@ public:
     // Convert big-endian hex to decimal string
     static std::string hexToDecimal(const std::string& hex);
     
+    // Convert big-endian bytes to decimal string
+    static std::string bytesToDecimal(const uint8_t* bytes, size_t length);
+    
     // Check if string is valid hex
     static bool isValidHex(const std::string& hex);
 };
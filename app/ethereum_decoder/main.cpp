@@ -1,10 +1,27 @@
 #include "include/ethereum_decoder.h"
 #include "include/crypto/type_decoder.h"
 #include "include/utils.h"
+#include "include/decoding/log_data.h"
 #include <algorithm>
+#include <stdexcept>
 
 namespace ethereum_decoder {
-    EthereumDecoder::EthereumDecoder(std::unique_ptr<ABI> abi) : abi_(std::move(abi)) {
+    namespace {
+        // Events added to the ABI by hand may not carry a plan; compiling here surfaces type errors
+        std::shared_ptr<const EventDecodePlan> planFor(const ABIEvent &event) {
+            return event.decodePlan ? event.decodePlan : DecodePlanCompiler::compile(event);
+        }
+    } // anonymous namespace
+
+    EthereumDecoder::EthereumDecoder(std::unique_ptr<ABI> abi, const SignatureRegistry *registry)
+        : abi_(abi ? std::move(abi) : std::make_unique<ABI>()), registry_(registry) {
+        // Canonicalise signatures to raw bytes once so lookups never touch strings
+        for (const auto &[signature, event]: abi_->eventsBySignature) {
+            Bytes32 topic;
+            if (EventLookupTable::parseTopic(signature, topic)) {
+                eventsByTopic_.insert(topic, &event);
+            }
+        }
     }
 
     std::unique_ptr<DecodedLog> EthereumDecoder::decodeLog(const LogEntry &log) {
@@ -12,12 +29,11 @@ namespace ethereum_decoder {
             throw std::runtime_error("Log entry has no topics");
         }
 
-        const ABIEvent *event = findEvent(log.topics[0]);
-
-        auto decodedLog = std::make_unique<DecodedLog>();
-        decodedLog->rawLog = log;
+        const ABIEvent *event = findEvent(log);
 
         if (!event) {
+            auto decodedLog = std::make_unique<DecodedLog>();
+            decodedLog->rawLog = log;
             decodedLog->eventName = "UnknownEvent";
             decodedLog->eventSignature = log.topics[0];
 
@@ -66,39 +82,59 @@ namespace ethereum_decoder {
             return decodedLog;
         }
 
-        decodedLog->eventName = event->name;
-        decodedLog->eventSignature = event->signature;
+        std::shared_ptr<const EventDecodePlan> plan = planFor(*event);
 
-        std::vector<ABIInput> indexedInputs;
-        std::vector<ABIInput> nonIndexedInputs;
+        // Only the topics that carry indexed params are parsed
+        std::array<Bytes32, 4> topics;
+        size_t topicCount = std::min({log.topics.size(), plan->topicParams.size() + 1, topics.size()});
+        for (size_t i = 0; i < topicCount; i++) {
+            Utils::hexToBytes(log.topics[i], topics[i].data(), topics[i].size());
+        }
 
-        for (const auto &input: event->inputs) {
-            if (input.indexed) {
-                indexedInputs.push_back(input);
-            } else {
-                nonIndexedInputs.push_back(input);
-            }
+        // Hex-decode the payload once, then walk the ABI words in place
+        Bytes data;
+        if (!plan->dataParams.empty() && !log.data.empty() && log.data != "0x") {
+            data = Utils::hexToBytes(log.data);
         }
 
-        std::vector<DecodedParam> indexedParams = decodeTopics(
-            std::vector<Hash>(log.topics.begin() + 1, log.topics.end()),
-            indexedInputs
-        );
+        auto decodedLog = decodeEvent(*event, *plan, topics.data(), topicCount, data.data(), data.size());
+        decodedLog->rawLog = log;
+        return decodedLog;
+    }
 
-        std::vector<DecodedParam> dataParams = decodeData(log.data, nonIndexedInputs);
+    std::unique_ptr<DecodedLog> EthereumDecoder::decodeLog(const RawLogEntry &log) {
+        if (log.topicCount == 0) {
+            throw std::runtime_error("Log entry has no topics");
+        }
 
-        size_t indexedIdx = 0;
-        size_t nonIndexedIdx = 0;
+        const ABIEvent *event = findEvent(log.topics[0], log.topicCount);
+        if (!event) {
+            return decodeLog(LogData::toLogEntry(log));
+        }
 
-        for (const auto &input: event->inputs) {
-            if (input.indexed) {
-                if (indexedIdx < indexedParams.size()) {
-                    decodedLog->params.push_back(indexedParams[indexedIdx++]);
-                }
-            } else {
-                if (nonIndexedIdx < dataParams.size()) {
-                    decodedLog->params.push_back(dataParams[nonIndexedIdx++]);
-                }
+        std::shared_ptr<const EventDecodePlan> plan = planFor(*event);
+        auto decodedLog = decodeEvent(*event, *plan, log.topics.data(), log.topicCount,
+                                      reinterpret_cast<const uint8_t *>(log.data.data()), log.data.size());
+        decodedLog->rawLog = LogData::toLogEntry(log);
+        return decodedLog;
+    }
+
+    std::unique_ptr<DecodedLog> EthereumDecoder::decodeEvent(const ABIEvent &event, const EventDecodePlan &plan,
+                                                             const Bytes32 *topics, size_t topicCount,
+                                                             const uint8_t *data, size_t dataLength) {
+        auto decodedLog = std::make_unique<DecodedLog>();
+        decodedLog->eventName = event.name;
+        decodedLog->eventSignature = event.signature;
+
+        std::vector<std::optional<DecodedValue>> values(event.inputs.size());
+        decodeTopics(topics, topicCount, plan, values);
+        decodeData(data, dataLength, plan, values);
+
+        decodedLog->params.reserve(event.inputs.size());
+        for (size_t i = 0; i < event.inputs.size(); i++) {
+            if (values[i]) {
+                const ABIInput& input = event.inputs[i];
+                decodedLog->params.push_back({input.name, input.type, std::move(*values[i]), input.indexed});
             }
         }
 
@@ -119,73 +155,49 @@ namespace ethereum_decoder {
         return decodedLogs;
     }
 
-    std::vector<DecodedParam> EthereumDecoder::decodeTopics(const std::vector<Hash> &topics,
-                                                       const std::vector<ABIInput> &inputs) {
-        std::vector<DecodedParam> params;
-
-        for (size_t i = 0; i < inputs.size() && i < topics.size(); i++) {
-            DecodedParam param;
-            param.name = inputs[i].name;
-            param.type = inputs[i].type;
-
-            if (inputs[i].type == "string" || inputs[i].type == "bytes" ||
-                inputs[i].type.find("[") != std::string::npos) {
-                param.value = topics[i];
+    void EthereumDecoder::decodeTopics(const Bytes32 *topics, size_t topicCount, const EventDecodePlan &plan,
+                                       std::vector<std::optional<DecodedValue> > &values) {
+        // topics[0] is the event signature, indexed params follow in declaration order
+        for (size_t i = 0; i < plan.topicParams.size() && i + 1 < topicCount; i++) {
+            const ParamPlan &param = plan.topicParams[i];
+            const Bytes32 &topic = topics[i + 1];
+
+            // Indexed dynamic values, arrays and tuples are stored as their keccak hash
+            if (param.type.dynamic || param.type.opcode == ABIOpcode::DynamicArray ||
+                param.type.opcode == ABIOpcode::FixedArray || param.type.opcode == ABIOpcode::Tuple) {
+                values[param.inputIndex] = "0x" + Utils::bytesToHex(topic.data(), topic.size());
             } else {
                 size_t offset = 0;
-                std::string topicData = Utils::removeHexPrefix(topics[i]);
-                param.value = TypeDecoder::decodeValue(inputs[i].type, topicData, offset);
+                values[param.inputIndex] = TypeDecoder::decodeValue(param.type, topic.data(), topic.size(), offset);
             }
-
-            params.push_back(param);
         }
-
-        return params;
     }
 
-    std::vector<DecodedParam> EthereumDecoder::decodeData(const std::string &data,
-                                                     const std::vector<ABIInput> &inputs) {
-        std::vector<DecodedParam> params;
-
-        if (inputs.empty() || data.empty() || data == "0x") {
-            return params;
+    void EthereumDecoder::decodeData(const uint8_t *data, size_t dataLength, const EventDecodePlan &plan,
+                                     std::vector<std::optional<DecodedValue> > &values) {
+        if (plan.dataParams.empty() || dataLength == 0) {
+            return;
         }
 
-        std::vector<std::string> types;
-        for (const auto &input: inputs) {
-            types.push_back(input.type);
+        std::vector<DecodedValue> decoded = TypeDecoder::decodeParams(plan.dataParams, data, dataLength);
+        for (size_t i = 0; i < decoded.size(); i++) {
+            values[plan.dataParams[i].inputIndex] = std::move(decoded[i]);
         }
-
-        std::vector<DecodedValue> values = TypeDecoder::decodeValues(types, data);
-
-        for (size_t i = 0; i < inputs.size() && i < values.size(); i++) {
-            DecodedParam param;
-            param.name = inputs[i].name;
-            param.type = inputs[i].type;
-            param.value = values[i];
-            params.push_back(param);
-        }
-
-        return params;
     }
 
-    const ABIEvent *EthereumDecoder::findEvent(const std::string &signature) {
-        auto it = abi_->eventsBySignature.find(signature);
-        if (it != abi_->eventsBySignature.end()) {
-            return &it->second;
-        }
-
-        std::string cleanSig = Utils::removeHexPrefix(signature);
-        it = abi_->eventsBySignature.find(cleanSig);
-        if (it != abi_->eventsBySignature.end()) {
-            return &it->second;
+    const ABIEvent *EthereumDecoder::findEvent(const LogEntry &log) {
+        Bytes32 topic;
+        if (!EventLookupTable::parseTopic(log.topics[0], topic)) {
+            return nullptr;
         }
+        return findEvent(topic, log.topics.size());
+    }
 
-        it = abi_->eventsBySignature.find("0x" + cleanSig);
-        if (it != abi_->eventsBySignature.end()) {
-            return &it->second;
+    const ABIEvent *EthereumDecoder::findEvent(const Bytes32 &topic0, size_t topicCount) {
+        // The contract's own ABI wins; the registry only fills in events it does not declare
+        if (const ABIEvent *event = eventsByTopic_.find(topic0)) {
+            return event;
         }
-
-        return nullptr;
+        return registry_ ? registry_->find(topic0, topicCount - 1) : nullptr;
     }
 } // namespace ethereum_decoder
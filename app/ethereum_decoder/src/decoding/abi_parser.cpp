@@ -4,6 +4,7 @@
 #else
 #include "../include/crypto/keccak256_simple.h"
 #endif
+#include "../include/decoding/decode_plan.h"
 #include "../include/utils.h"
 #include <nlohmann/json.hpp>
 #include <fstream>
@@ -22,6 +23,13 @@ std::unique_ptr<ABI> ABIParser::parseFromString(const std::string& jsonStr) {
                 ABIEvent event = parseEvent(item);
                 event.signature = computeEventSignature(event);
                 
+                // Compile the decode plan once; unsupported types surface when a log is decoded
+                try {
+                    event.decodePlan = DecodePlanCompiler::compile(event);
+                } catch (const std::runtime_error&) {
+                    event.decodePlan = nullptr;
+                }
+                
                 abi->events.push_back(event);
                 abi->eventsBySignature[event.signature] = event;
             }
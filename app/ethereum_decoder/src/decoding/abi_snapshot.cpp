@@ -0,0 +1,326 @@
+#include "../include/decoding/abi_snapshot.h"
+#include "../include/decoding/decode_plan.h"
+#include "../include/utils.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace ethereum_decoder {
+
+namespace {
+
+constexpr char MAGIC[8] = {'E', 'D', 'A', 'B', 'I', 'S', 'N', 'P'};
+constexpr size_t HEADER_SIZE = 24;
+constexpr size_t INDEX_ENTRY_SIZE = 32;
+constexpr size_t ADDRESS_SIZE = 20;
+
+// Tuples nest, but never this deep in a real ABI; guards against corrupt files
+constexpr size_t MAX_COMPONENT_DEPTH = 32;
+
+void putU32(std::string& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<char>(value >> (i * 8)));
+    }
+}
+
+void putU64(std::string& out, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        out.push_back(static_cast<char>(value >> (i * 8)));
+    }
+}
+
+void putString(std::string& out, const std::string& value) {
+    putU32(out, static_cast<uint32_t>(value.size()));
+    out += value;
+}
+
+void putInput(std::string& out, const ABIInput& input) {
+    putString(out, input.name);
+    putString(out, input.type);
+    out.push_back(input.indexed ? 1 : 0);
+    putU32(out, static_cast<uint32_t>(input.components.size()));
+    for (const auto& component : input.components) {
+        putInput(out, component);
+    }
+}
+
+uint64_t getLE(const uint8_t* data, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(data[i]) << (i * 8);
+    }
+    return value;
+}
+
+// Bounds-checked reader over a single record
+class RecordReader {
+public:
+    RecordReader(const uint8_t* data, size_t length) : data_(data), length_(length) {}
+
+    uint8_t u8() {
+        require(1);
+        return data_[pos_++];
+    }
+
+    uint32_t u32() {
+        require(4);
+        uint32_t value = static_cast<uint32_t>(getLE(data_ + pos_, 4));
+        pos_ += 4;
+        return value;
+    }
+
+    std::string string() {
+        uint32_t size = u32();
+        require(size);
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), size);
+        pos_ += size;
+        return value;
+    }
+
+    ABIInput input(size_t depth = 0) {
+        if (depth > MAX_COMPONENT_DEPTH) {
+            throw std::runtime_error("Corrupt ABI snapshot: components nested too deeply");
+        }
+
+        ABIInput input;
+        input.name = string();
+        input.type = string();
+        input.indexed = u8() != 0;
+        uint32_t componentCount = u32();
+        for (uint32_t i = 0; i < componentCount; i++) {
+            input.components.push_back(this->input(depth + 1));
+        }
+        return input;
+    }
+
+private:
+    void require(size_t bytes) const {
+        if (bytes > length_ - pos_) {
+            throw std::runtime_error("Corrupt ABI snapshot: record truncated");
+        }
+    }
+
+    const uint8_t* data_;
+    size_t length_;
+    size_t pos_ = 0;
+};
+
+bool parseAddress(const std::string& address, AddressBytes& bytes) {
+    try {
+        Utils::hexToBytes(address, bytes.data(), bytes.size());
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+std::unique_ptr<ABISnapshot> ABISnapshot::open(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Failed to open ABI snapshot: " + path);
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < HEADER_SIZE) {
+        ::close(fd);
+        throw std::runtime_error("Invalid ABI snapshot: " + path);
+    }
+
+    size_t length = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Failed to map ABI snapshot: " + path);
+    }
+
+    std::unique_ptr<ABISnapshot> snapshot(new ABISnapshot());
+    snapshot->data_ = static_cast<const uint8_t*>(mapping);
+    snapshot->length_ = length;
+
+    const uint8_t* data = snapshot->data_;
+    if (std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error("Not an ABI snapshot: " + path);
+    }
+
+    uint32_t version = static_cast<uint32_t>(getLE(data + 8, 4));
+    if (version != VERSION) {
+        throw std::runtime_error("Unsupported ABI snapshot version " + std::to_string(version) + ": " + path);
+    }
+
+    snapshot->count_ = static_cast<size_t>(getLE(data + 12, 4));
+    uint64_t indexOffset = getLE(data + 16, 8);
+    if (indexOffset > length || snapshot->count_ > (length - indexOffset) / INDEX_ENTRY_SIZE) {
+        throw std::runtime_error("Corrupt ABI snapshot index: " + path);
+    }
+    snapshot->index_ = data + indexOffset;
+
+    return snapshot;
+}
+
+ABISnapshot::~ABISnapshot() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), length_);
+    }
+}
+
+bool ABISnapshot::contains(const std::string& address) const {
+    AddressBytes bytes;
+    const uint8_t* record;
+    size_t length;
+    return parseAddress(address, bytes) && findRecord(bytes, record, length);
+}
+
+std::unique_ptr<ABI> ABISnapshot::load(const std::string& address, std::string* name) const {
+    AddressBytes bytes;
+    const uint8_t* record;
+    size_t length;
+    if (!parseAddress(address, bytes) || !findRecord(bytes, record, length)) {
+        return nullptr;
+    }
+
+    RecordReader reader(record, length);
+    std::string contractName = reader.string();
+    if (name) {
+        *name = contractName;
+    }
+
+    auto abi = std::make_unique<ABI>();
+    uint32_t eventCount = reader.u32();
+    for (uint32_t i = 0; i < eventCount; i++) {
+        ABIEvent event;
+        event.name = reader.string();
+        event.anonymous = reader.u8() != 0;
+        event.signature = reader.string();
+
+        uint32_t inputCount = reader.u32();
+        for (uint32_t j = 0; j < inputCount; j++) {
+            event.inputs.push_back(reader.input());
+        }
+
+        // Plans are cheap to derive from the type strings, unlike the keccak signatures
+        try {
+            event.decodePlan = DecodePlanCompiler::compile(event);
+        } catch (const std::runtime_error&) {
+            event.decodePlan = nullptr;
+        }
+
+        abi->events.push_back(event);
+        abi->eventsBySignature[event.signature] = event;
+    }
+
+    return abi;
+}
+
+bool ABISnapshot::findRecord(const AddressBytes& address, const uint8_t*& record, size_t& length) const {
+    size_t low = 0;
+    size_t high = count_;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const uint8_t* entry = index_ + mid * INDEX_ENTRY_SIZE;
+
+        int cmp = std::memcmp(entry, address.data(), ADDRESS_SIZE);
+        if (cmp < 0) {
+            low = mid + 1;
+        } else if (cmp > 0) {
+            high = mid;
+        } else {
+            length = static_cast<size_t>(getLE(entry + 20, 4));
+            uint64_t offset = getLE(entry + 24, 8);
+            if (offset > length_ || length > length_ - offset) {
+                throw std::runtime_error("Corrupt ABI snapshot: record out of range");
+            }
+            record = data_ + offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ABISnapshotWriter::add(const std::string& address, const std::string& name, const ABI& abi) {
+    AddressBytes bytes;
+    if (!parseAddress(address, bytes)) {
+        throw std::runtime_error("Invalid contract address: " + address);
+    }
+
+    std::string record;
+    putString(record, name);
+    putU32(record, static_cast<uint32_t>(abi.events.size()));
+    for (const auto& event : abi.events) {
+        putString(record, event.name);
+        record.push_back(event.anonymous ? 1 : 0);
+        putString(record, event.signature);
+        putU32(record, static_cast<uint32_t>(event.inputs.size()));
+        for (const auto& input : event.inputs) {
+            putInput(record, input);
+        }
+    }
+
+    records_[bytes] = std::move(record);
+}
+
+void ABISnapshotWriter::addAll(const ABISnapshot& snapshot) {
+    for (size_t i = 0; i < snapshot.count_; i++) {
+        const uint8_t* entry = snapshot.index_ + i * INDEX_ENTRY_SIZE;
+        AddressBytes address;
+        std::memcpy(address.data(), entry, ADDRESS_SIZE);
+        if (records_.count(address)) {
+            continue;
+        }
+
+        const uint8_t* record;
+        size_t length;
+        if (snapshot.findRecord(address, record, length)) {
+            records_[address] = std::string(reinterpret_cast<const char*>(record), length);
+        }
+    }
+}
+
+void ABISnapshotWriter::write(const std::string& path) const {
+    std::string header(MAGIC, sizeof(MAGIC));
+    putU32(header, ABISnapshot::VERSION);
+    putU32(header, static_cast<uint32_t>(records_.size()));
+
+    uint64_t offset = HEADER_SIZE;
+    std::string index;
+    index.reserve(records_.size() * INDEX_ENTRY_SIZE);
+    for (const auto& [address, record] : records_) {
+        index.append(reinterpret_cast<const char*>(address.data()), ADDRESS_SIZE);
+        putU32(index, static_cast<uint32_t>(record.size()));
+        putU64(index, offset);
+        offset += record.size();
+    }
+    putU64(header, offset);
+
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            throw std::runtime_error("Failed to create ABI snapshot: " + tempPath);
+        }
+
+        file.write(header.data(), header.size());
+        for (const auto& [address, record] : records_) {
+            file.write(record.data(), record.size());
+        }
+        file.write(index.data(), index.size());
+
+        if (!file) {
+            throw std::runtime_error("Failed to write ABI snapshot: " + tempPath);
+        }
+    }
+
+    // Readers that still map the old file keep a valid view after the rename
+    if (std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::remove(tempPath.c_str());
+        throw std::runtime_error("Failed to replace ABI snapshot: " + path);
+    }
+}
+
+} // namespace ethereum_decoder
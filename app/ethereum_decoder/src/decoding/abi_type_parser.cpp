@@ -0,0 +1,157 @@
+#include "../include/decoding/abi_type_parser.h"
+
+namespace ethereum_decoder {
+
+bool ABITypeParser::parse(std::string_view type, ABITypeInfo& info) {
+    info = ABITypeInfo();
+
+    // Array suffixes bind from the right: T[2][] is a dynamic array of T[2]
+    if (!type.empty() && type.back() == ']') {
+        size_t open = type.rfind('[');
+        if (open == std::string_view::npos || open == 0) {
+            return false;
+        }
+
+        std::string_view digits = type.substr(open + 1, type.size() - open - 2);
+        info.inner = type.substr(0, open);
+        if (digits.empty()) {
+            info.opcode = ABIOpcode::DynamicArray;
+            return true;
+        }
+
+        info.opcode = ABIOpcode::FixedArray;
+        return parseNumber(digits, 9, info.arrayLength);
+    }
+
+    // Canonical tuple notation "(T1,T2)" or a bare "tuple" whose components live in the ABI
+    if (!type.empty() && type.front() == '(') {
+        if (type.back() != ')') {
+            return false;
+        }
+        info.opcode = ABIOpcode::Tuple;
+        info.inner = type.substr(1, type.size() - 2);
+        return true;
+    }
+    if (type == "tuple") {
+        info.opcode = ABIOpcode::Tuple;
+        return true;
+    }
+
+    if (type == "address") {
+        info.opcode = ABIOpcode::Address;
+        info.size = 20;
+        return true;
+    }
+    if (type == "bool") {
+        info.opcode = ABIOpcode::Bool;
+        return true;
+    }
+    if (type == "string") {
+        info.opcode = ABIOpcode::String;
+        return true;
+    }
+    if (type == "bytes") {
+        info.opcode = ABIOpcode::Bytes;
+        return true;
+    }
+    if (type == "function") {
+        // Address followed by a 4-byte selector
+        info.opcode = ABIOpcode::FixedBytes;
+        info.size = 24;
+        return true;
+    }
+    if (type == "byte") {
+        info.opcode = ABIOpcode::FixedBytes;
+        info.size = 1;
+        return true;
+    }
+
+    if (type.substr(0, 4) == "uint" || type.substr(0, 3) == "int") {
+        bool isUnsigned = type[0] == 'u';
+        std::string_view bits = type.substr(isUnsigned ? 4 : 3);
+        info.opcode = isUnsigned ? ABIOpcode::Uint : ABIOpcode::Int;
+        info.size = 256;
+        if (!bits.empty() && !parseNumber(bits, 3, info.size)) {
+            return false;
+        }
+        return info.size > 0 && info.size <= 256 && info.size % 8 == 0;
+    }
+
+    if (type.substr(0, 5) == "bytes") {
+        info.opcode = ABIOpcode::FixedBytes;
+        if (!parseNumber(type.substr(5), 2, info.size)) {
+            return false;
+        }
+        return info.size > 0 && info.size <= 32;
+    }
+
+    return false;
+}
+
+bool ABITypeParser::nextComponent(std::string_view& components, std::string_view& component) {
+    if (components.empty()) {
+        return false;
+    }
+
+    // Only commas outside nested parentheses separate components
+    size_t depth = 0;
+    size_t end = 0;
+    for (; end < components.size(); end++) {
+        char c = components[end];
+        if (c == '(') {
+            depth++;
+        } else if (c == ')' && depth > 0) {
+            depth--;
+        } else if (c == ',' && depth == 0) {
+            break;
+        }
+    }
+
+    component = components.substr(0, end);
+    components = end < components.size() ? components.substr(end + 1) : std::string_view();
+    return true;
+}
+
+bool ABITypeParser::isDynamic(std::string_view type) {
+    ABITypeInfo info;
+    if (!parse(type, info)) {
+        return false;
+    }
+
+    switch (info.opcode) {
+        case ABIOpcode::Bytes:
+        case ABIOpcode::String:
+        case ABIOpcode::DynamicArray:
+            return true;
+        case ABIOpcode::FixedArray:
+            return isDynamic(info.inner);
+        case ABIOpcode::Tuple: {
+            std::string_view component;
+            while (nextComponent(info.inner, component)) {
+                if (isDynamic(component)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        default:
+            return false;
+    }
+}
+
+bool ABITypeParser::parseNumber(std::string_view digits, size_t maxDigits, size_t& value) {
+    if (digits.empty() || digits.size() > maxDigits) {
+        return false;
+    }
+
+    value = 0;
+    for (char c : digits) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<size_t>(c - '0');
+    }
+    return true;
+}
+
+} // namespace ethereum_decoder
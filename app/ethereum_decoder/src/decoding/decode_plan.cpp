@@ -0,0 +1,83 @@
+#include "../include/decoding/decode_plan.h"
+#include "../include/decoding/abi_type_parser.h"
+#include <stdexcept>
+
+namespace ethereum_decoder {
+
+std::shared_ptr<const EventDecodePlan> DecodePlanCompiler::compile(const ABIEvent& event) {
+    auto plan = std::make_shared<EventDecodePlan>();
+
+    for (size_t i = 0; i < event.inputs.size(); i++) {
+        const ABIInput& input = event.inputs[i];
+
+        ParamPlan param;
+        param.inputIndex = i;
+        param.type = compileType(input.type, input.components);
+
+        if (input.indexed) {
+            plan->topicParams.push_back(std::move(param));
+        } else {
+            plan->dataHeadSize += param.type.headSize;
+            plan->dataParams.push_back(std::move(param));
+        }
+    }
+
+    return plan;
+}
+
+ABITypePlan DecodePlanCompiler::compileType(std::string_view type, const std::vector<ABIInput>& components) {
+    ABITypeInfo info;
+    if (!ABITypeParser::parse(type, info)) {
+        throw std::runtime_error("Unsupported type: " + std::string(type));
+    }
+
+    ABITypePlan plan;
+    plan.opcode = info.opcode;
+    plan.size = info.size;
+
+    switch (info.opcode) {
+        case ABIOpcode::DynamicArray:
+        case ABIOpcode::FixedArray: {
+            // ABI tuple components describe the innermost element of tuple arrays
+            plan.children.push_back(compileType(info.inner, components));
+            const ABITypePlan& element = plan.children.front();
+
+            plan.arrayLength = info.arrayLength;
+            plan.dynamic = info.opcode == ABIOpcode::DynamicArray || element.dynamic;
+            plan.headSize = plan.dynamic ? 32 : plan.arrayLength * element.headSize;
+            break;
+        }
+        case ABIOpcode::Tuple: {
+            size_t staticSize = 0;
+            if (info.inner.empty()) {
+                for (const auto& component : components) {
+                    plan.children.push_back(compileType(component.type, component.components));
+                    plan.componentNames.push_back(component.name);
+                }
+            } else {
+                // Canonical "(T1,T2)" notation carries unnamed components
+                std::string_view component;
+                while (ABITypeParser::nextComponent(info.inner, component)) {
+                    plan.children.push_back(compileType(component));
+                    plan.componentNames.emplace_back();
+                }
+            }
+            for (const auto& child : plan.children) {
+                plan.dynamic = plan.dynamic || child.dynamic;
+                staticSize += child.headSize;
+            }
+            plan.headSize = plan.dynamic ? 32 : staticSize;
+            break;
+        }
+        case ABIOpcode::Bytes:
+        case ABIOpcode::String:
+            plan.dynamic = true;
+            break;
+        default:
+            break;
+    }
+
+    return plan;
+}
+
+} // namespace ethereum_decoder
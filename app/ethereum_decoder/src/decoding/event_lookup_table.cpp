@@ -0,0 +1,75 @@
+#include "../include/decoding/event_lookup_table.h"
+#include "../include/utils.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace ethereum_decoder {
+
+void EventLookupTable::insert(const Bytes32& topic, const ABIEvent* event) {
+    // Keep the load factor at or below one half so probe sequences stay short
+    if ((size_ + 1) * 2 > slots_.size()) {
+        grow();
+    }
+
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hashTopic(topic) & mask;; i = (i + 1) & mask) {
+        Slot& slot = slots_[i];
+        if (!slot.event) {
+            slot.topic = topic;
+            slot.event = event;
+            size_++;
+            return;
+        }
+        if (slot.topic == topic) {
+            slot.event = event;
+            return;
+        }
+    }
+}
+
+const ABIEvent* EventLookupTable::find(const Bytes32& topic) const {
+    if (slots_.empty()) {
+        return nullptr;
+    }
+
+    size_t mask = slots_.size() - 1;
+    for (size_t i = hashTopic(topic) & mask;; i = (i + 1) & mask) {
+        const Slot& slot = slots_[i];
+        if (!slot.event) {
+            return nullptr;
+        }
+        if (slot.topic == topic) {
+            return slot.event;
+        }
+    }
+}
+
+bool EventLookupTable::parseTopic(const std::string& hex, Bytes32& topic) {
+    // hexToBytes rejects anything that is not exactly 64 hex digits
+    try {
+        Utils::hexToBytes(hex, topic.data(), topic.size());
+    } catch (const std::runtime_error&) {
+        return false;
+    }
+    return true;
+}
+
+size_t EventLookupTable::hashTopic(const Bytes32& topic) {
+    uint64_t hash;
+    std::memcpy(&hash, topic.data(), sizeof(hash));
+    return static_cast<size_t>(hash);
+}
+
+void EventLookupTable::grow() {
+    std::vector<Slot> old = std::move(slots_);
+    slots_.assign(old.empty() ? 16 : old.size() * 2, Slot());
+    size_ = 0;
+
+    for (const Slot& slot : old) {
+        if (slot.event) {
+            insert(slot.topic, slot.event);
+        }
+    }
+}
+
+} // namespace ethereum_decoder
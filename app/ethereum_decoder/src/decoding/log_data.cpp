@@ -1,4 +1,5 @@
 #include "../include/decoding/log_data.h"
+#include "../include/utils.h"
 #include <sstream>
 #include <stdexcept>
 
@@ -38,4 +39,15 @@ LogEntry LogData::parse(const std::string& logData) {
     return log;
 }
 
+LogEntry LogData::toLogEntry(const RawLogEntry& log) {
+    LogEntry entry;
+    entry.address = std::string(log.address);
+    entry.topics.reserve(log.topicCount);
+    for (size_t i = 0; i < log.topicCount; i++) {
+        entry.topics.push_back("0x" + Utils::bytesToHex(log.topics[i].data(), log.topics[i].size()));
+    }
+    entry.data = "0x" + Utils::bytesToHex(reinterpret_cast<const uint8_t*>(log.data.data()), log.data.size());
+    return entry;
+}
+
 } // namespace ethereum_decoder
\ No newline at end of file
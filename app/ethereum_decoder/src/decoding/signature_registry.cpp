@@ -0,0 +1,80 @@
+#include "../include/decoding/signature_registry.h"
+#include "../include/decoding/decode_plan.h"
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace ethereum_decoder {
+
+SignatureRegistry& SignatureRegistry::global() {
+    static SignatureRegistry registry;
+    return registry;
+}
+
+size_t SignatureRegistry::registerABI(const ABI& abi) {
+    size_t added = 0;
+
+    for (const auto& event : abi.events) {
+        if (event.anonymous) {
+            continue;
+        }
+
+        size_t indexedCount = std::count_if(event.inputs.begin(), event.inputs.end(),
+                                            [](const ABIInput& input) { return input.indexed; });
+        Bytes32 topic;
+        if (indexedCount > MAX_INDEXED || !EventLookupTable::parseTopic(event.signature, topic)) {
+            continue;
+        }
+
+        // Most ABIs only repeat events we already know, so check under the shared lock first
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex_);
+            if (tables_[indexedCount].find(topic)) {
+                continue;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        if (tables_[indexedCount].find(topic)) {
+            continue;
+        }
+
+        events_.push_back(event);
+        ABIEvent& stored = events_.back();
+        if (!stored.decodePlan) {
+            try {
+                stored.decodePlan = DecodePlanCompiler::compile(stored);
+            } catch (const std::runtime_error&) {
+                // Keep the event; decoding reports the unsupported type
+            }
+        }
+        tables_[indexedCount].insert(topic, &stored);
+        added++;
+    }
+
+    return added;
+}
+
+const ABIEvent* SignatureRegistry::find(const Bytes32& topic0, size_t indexedCount) const {
+    if (indexedCount > MAX_INDEXED) {
+        return nullptr;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return tables_[indexedCount].find(topic0);
+}
+
+const ABIEvent* SignatureRegistry::find(const std::string& topic0, size_t indexedCount) const {
+    Bytes32 topic;
+    if (!EventLookupTable::parseTopic(topic0, topic)) {
+        return nullptr;
+    }
+    return find(topic, indexedCount);
+}
+
+size_t SignatureRegistry::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    return events_.size();
+}
+
+} // namespace ethereum_decoder
@@ -1,282 +1,329 @@
 #include "../include/crypto/type_decoder.h"
 #include "../include/utils.h"
+#include "../include/uint256.h"
+#include "../include/decoding/abi_type_parser.h"
 #include <algorithm>
-#include <regex>
-#include <sstream>
+#include <stdexcept>
 
 namespace ethereum_decoder {
 
 DecodedValue TypeDecoder::decodeValue(const std::string& type, const std::string& hexData, size_t& offset) {
-    std::string cleanData = Utils::removeHexPrefix(hexData);
-    
-    // Handle address type
-    if (type == "address") {
-        return decodeAddress(cleanData, offset);
-    }
-    
-    // Handle uint types
-    if (type.find("uint") == 0) {
-        return decodeUint256(cleanData, offset);
-    }
-    
-    // Handle int types
-    if (type.find("int") == 0 && type.find("uint") != 0) {
-        return decodeInt256(cleanData, offset);
-    }
-    
-    // Handle bool type
-    if (type == "bool") {
-        return decodeBool(cleanData, offset);
-    }
-    
-    // Handle fixed bytes types (bytes1, bytes2, ..., bytes32)
-    std::regex fixedBytesRegex("^bytes([0-9]+)$");
-    std::smatch match;
-    if (std::regex_match(type, match, fixedBytesRegex)) {
-        size_t length = std::stoul(match[1].str());
-        return decodeBytes(cleanData, offset, length);
-    }
-    
-    // Handle dynamic bytes
-    if (type == "bytes") {
-        return decodeBytes(cleanData, offset, 0);
-    }
-    
-    // Handle string
-    if (type == "string") {
-        return decodeString(cleanData, offset);
-    }
-    
-    // Handle arrays
-    auto [elementType, arrayLength] = parseArrayType(type);
-    if (!elementType.empty()) {
-        auto arrayValues = decodeArray(elementType, cleanData, offset, arrayLength);
-        std::vector<std::string> stringArray;
-        for (const auto& val : arrayValues) {
-            if (std::holds_alternative<std::string>(val)) {
-                stringArray.push_back(std::get<std::string>(val));
-            }
-        }
-        return stringArray;
-    }
-    
-    throw std::runtime_error("Unsupported type: " + type);
+    std::vector<uint8_t> bytes = Utils::hexToBytes(hexData);
+
+    // Hex offsets map onto byte offsets two characters per byte
+    size_t byteOffset = offset / 2;
+    DecodedValue value = decodeValue(type, bytes.data(), bytes.size(), byteOffset);
+    offset = byteOffset * 2;
+
+    return value;
 }
 
 std::vector<DecodedValue> TypeDecoder::decodeValues(const std::vector<std::string>& types, const std::string& hexData) {
+    std::vector<uint8_t> bytes = Utils::hexToBytes(hexData);
+    return decodeValues(types, bytes.data(), bytes.size());
+}
+
+DecodedValue TypeDecoder::decodeValue(const std::string& type, const uint8_t* data, size_t length, size_t& offset) {
+    return decodeTypeString(type, data, length, offset);
+}
+
+std::vector<DecodedValue> TypeDecoder::decodeValues(const std::vector<std::string>& types, const uint8_t* data, size_t length) {
     std::vector<DecodedValue> values(types.size()); // Pre-allocate with correct size
-    std::string cleanData = Utils::removeHexPrefix(hexData);
     size_t offset = 0;
-    
-    // First pass: decode static types and collect dynamic offsets
-    std::vector<size_t> dynamicOffsets;
-    std::vector<size_t> dynamicIndices;
-    
+
+    // Head: static values are inline, dynamic values store an offset from the start of the data
     for (size_t i = 0; i < types.size(); i++) {
-        if (isDynamicType(types[i])) {
-            // Read the offset for dynamic data
-            std::string offsetHex = readBytes32(cleanData, offset);
-            size_t dynamicOffset = std::stoull(offsetHex, nullptr, 16) * 2; // Convert to hex char offset
-            dynamicOffsets.push_back(dynamicOffset);
-            dynamicIndices.push_back(i);
-            values[i] = ""; // Placeholder
+        if (ABITypeParser::isDynamic(types[i])) {
+            size_t dynamicOffset = readSize(data, length, offset);
+            values[i] = decodeTypeString(types[i], data, length, dynamicOffset);
         } else {
-            values[i] = decodeValue(types[i], cleanData, offset);
+            values[i] = decodeTypeString(types[i], data, length, offset);
         }
     }
-    
-    // Second pass: decode dynamic types
-    for (size_t i = 0; i < dynamicIndices.size(); i++) {
-        size_t index = dynamicIndices[i];
-        size_t dynamicOffset = dynamicOffsets[i];
-        values[index] = decodeValue(types[index], cleanData, dynamicOffset);
-    }
-    
+
     return values;
 }
 
-std::string TypeDecoder::decodeAddress(const std::string& hexData, size_t& offset) {
-    std::string bytes32 = readBytes32(hexData, offset);
-    // Address is the last 20 bytes (40 hex chars) of the 32-byte value
-    return "0x" + bytes32.substr(24);
+DecodedValue TypeDecoder::decodeValue(const ABITypePlan& type, const uint8_t* data, size_t length,
+                                      size_t& headOffset, size_t base) {
+    if (type.dynamic) {
+        size_t pos = base + readSize(data, length, headOffset);
+        return decodeContent(type, data, length, pos);
+    }
+
+    DecodedValue value = decodeContent(type, data, length, headOffset);
+    headOffset += type.headSize;
+    return value;
 }
 
-std::string TypeDecoder::decodeUint256(const std::string& hexData, size_t& offset) {
-    std::string bytes32 = readBytes32(hexData, offset);
-    return Utils::hexToDecimal(bytes32);
+std::vector<DecodedValue> TypeDecoder::decodeParams(const std::vector<ParamPlan>& params, const uint8_t* data, size_t length) {
+    std::vector<DecodedValue> values;
+    values.reserve(params.size());
+
+    size_t headOffset = 0;
+    for (const auto& param : params) {
+        values.push_back(decodeValue(param.type, data, length, headOffset));
+    }
+
+    return values;
 }
 
-std::string TypeDecoder::decodeInt256(const std::string& hexData, size_t& offset) {
-    std::string bytes32 = readBytes32(hexData, offset);
-    
-    // Check if negative (first bit is 1)
-    if (bytes32[0] >= '8') {
-        // Convert two's complement
-        std::string inverted;
-        for (char c : bytes32) {
-            int val = (c >= '0' && c <= '9') ? (c - '0') : 
-                     (c >= 'a' && c <= 'f') ? (c - 'a' + 10) :
-                     (c >= 'A' && c <= 'F') ? (c - 'A' + 10) : 0;
-            int inv = 15 - val;
-            inverted += (inv < 10) ? ('0' + inv) : ('a' + inv - 10);
+DecodedValue TypeDecoder::decodeContent(const ABITypePlan& type, const uint8_t* data, size_t length, size_t pos) {
+    switch (type.opcode) {
+        case ABIOpcode::Address:
+            return decodeAddress(data, length, pos);
+        case ABIOpcode::Uint:
+            return decodeUint256(data, length, pos);
+        case ABIOpcode::Int:
+            return decodeInt256(data, length, pos);
+        case ABIOpcode::Bool:
+            return decodeBool(data, length, pos);
+        case ABIOpcode::FixedBytes:
+            if (type.size == WORD_SIZE) {
+                return decodeBytes32(data, length, pos);
+            }
+            return decodeBytes(data, length, pos, type.size);
+        case ABIOpcode::Bytes:
+            return decodeBytes(data, length, pos, 0);
+        case ABIOpcode::String:
+            return decodeString(data, length, pos);
+        case ABIOpcode::DynamicArray:
+        case ABIOpcode::FixedArray: {
+            const ABITypePlan& element = type.children.front();
+            size_t arrayLength = type.opcode == ABIOpcode::DynamicArray ? readSize(data, length, pos) : type.arrayLength;
+
+            // Element heads follow each other, which bounds a sane length
+            if (element.headSize > 0 && arrayLength > (length - std::min(pos, length)) / element.headSize) {
+                throw std::runtime_error("Array length " + std::to_string(arrayLength) + " exceeds available data");
+            }
+
+            std::vector<std::string> elements;
+            elements.reserve(arrayLength);
+            size_t headOffset = pos;
+            for (size_t i = 0; i < arrayLength; i++) {
+                elements.push_back(formatValue(decodeValue(element, data, length, headOffset, pos)));
+            }
+            return elements;
         }
-        
-        // Add 1
-        bool carry = true;
-        for (int i = inverted.length() - 1; i >= 0 && carry; i--) {
-            char c = inverted[i];
-            int val = (c >= '0' && c <= '9') ? (c - '0') : 
-                     (c >= 'a' && c <= 'f') ? (c - 'a' + 10) : 0;
-            val++;
-            if (val > 15) {
-                val = 0;
-            } else {
-                carry = false;
+        case ABIOpcode::Tuple: {
+            std::map<std::string, std::string> components;
+            size_t headOffset = pos;
+            for (size_t i = 0; i < type.children.size(); i++) {
+                const std::string& name = type.componentNames[i];
+                components[name.empty() ? std::to_string(i) : name] =
+                    formatValue(decodeValue(type.children[i], data, length, headOffset, pos));
             }
-            inverted[i] = (val < 10) ? ('0' + val) : ('a' + val - 10);
+            return components;
         }
-        
-        return "-" + Utils::hexToDecimal(inverted);
     }
-    
-    return Utils::hexToDecimal(bytes32);
+
+    throw std::runtime_error("Unsupported ABI opcode");
 }
 
-bool TypeDecoder::decodeBool(const std::string& hexData, size_t& offset) {
-    std::string bytes32 = readBytes32(hexData, offset);
-    return bytes32 != std::string(64, '0');
+std::string TypeDecoder::formatValue(const DecodedValue& value) {
+    return std::visit([](const auto& val) -> std::string {
+        using T = std::decay_t<decltype(val)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            return val;
+        } else if constexpr (std::is_same_v<T, uint64_t> || std::is_same_v<T, int64_t>) {
+            return std::to_string(val);
+        } else if constexpr (std::is_same_v<T, bool>) {
+            return val ? "true" : "false";
+        } else if constexpr (std::is_same_v<T, std::vector<uint8_t>>) {
+            return "0x" + Utils::bytesToHex(val);
+        } else if constexpr (std::is_same_v<T, UInt256> || std::is_same_v<T, Int256>) {
+            return val.toDecimal();
+        } else if constexpr (std::is_same_v<T, AddressBytes> || std::is_same_v<T, Bytes32>) {
+            return "0x" + Utils::bytesToHex(val.data(), val.size());
+        } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
+            std::string result = "[";
+            for (size_t i = 0; i < val.size(); i++) {
+                if (i > 0) result += ",";
+                result += val[i];
+            }
+            return result + "]";
+        } else {
+            std::string result = "{";
+            bool first = true;
+            for (const auto& [k, v] : val) {
+                if (!first) result += ",";
+                result += k + ":" + v;
+                first = false;
+            }
+            return result + "}";
+        }
+    }, value);
 }
 
-std::vector<uint8_t> TypeDecoder::decodeBytes(const std::string& hexData, size_t& offset, size_t length) {
-    if (length > 0) {
-        // Fixed-size bytes
-        std::string bytes32 = readBytes32(hexData, offset);
-        return Utils::hexToBytes(bytes32.substr(0, length * 2));
-    } else {
-        // Dynamic bytes
-        // First read the length
-        std::string lengthHex = readBytes32(hexData, offset);
-        size_t dataLength = std::stoull(lengthHex, nullptr, 16);
-        
-        // Then read the actual data
-        std::vector<uint8_t> result;
-        size_t hexChars = dataLength * 2;
-        size_t chunks = (hexChars + 63) / 64; // Round up to nearest 32-byte chunk
-        
-        for (size_t i = 0; i < chunks; i++) {
-            std::string chunk = readBytes32(hexData, offset);
-            size_t charsToRead = std::min(hexChars - i * 64, size_t(64));
-            result.insert(result.end(), 
-                         Utils::hexToBytes(chunk.substr(0, charsToRead)).begin(),
-                         Utils::hexToBytes(chunk.substr(0, charsToRead)).end());
+AddressBytes TypeDecoder::decodeAddress(const uint8_t* data, size_t length, size_t& offset) {
+    const uint8_t* word = readWord(data, length, offset);
+    // Address is the last 20 bytes of the 32-byte word
+    AddressBytes address;
+    std::copy(word + 12, word + WORD_SIZE, address.begin());
+    return address;
+}
+
+UInt256 TypeDecoder::decodeUint256(const uint8_t* data, size_t length, size_t& offset) {
+    const uint8_t* word = readWord(data, length, offset);
+    return UInt256::fromBigEndian(word, WORD_SIZE);
+}
+
+Int256 TypeDecoder::decodeInt256(const uint8_t* data, size_t length, size_t& offset) {
+    const uint8_t* word = readWord(data, length, offset);
+    // Sign handling is deferred to formatting, the bits are kept as-is
+    return Int256{UInt256::fromBigEndian(word, WORD_SIZE)};
+}
+
+Bytes32 TypeDecoder::decodeBytes32(const uint8_t* data, size_t length, size_t& offset) {
+    const uint8_t* word = readWord(data, length, offset);
+    Bytes32 result;
+    std::copy(word, word + WORD_SIZE, result.begin());
+    return result;
+}
+
+bool TypeDecoder::decodeBool(const uint8_t* data, size_t length, size_t& offset) {
+    const uint8_t* word = readWord(data, length, offset);
+    return std::any_of(word, word + WORD_SIZE, [](uint8_t b) { return b != 0; });
+}
+
+std::vector<uint8_t> TypeDecoder::decodeBytes(const uint8_t* data, size_t length, size_t& offset, size_t size) {
+    if (size > 0) {
+        // Fixed-size bytes, left-aligned in a single word
+        if (size > WORD_SIZE) {
+            throw std::runtime_error("Invalid fixed bytes size: " + std::to_string(size));
         }
-        
-        return result;
+        const uint8_t* word = readWord(data, length, offset);
+        return std::vector<uint8_t>(word, word + size);
     }
+
+    // Dynamic bytes: length word followed by the right-padded data
+    size_t dataLength = readSize(data, length, offset);
+    if (dataLength > length - offset) {
+        throw std::runtime_error("Insufficient data to read " + std::to_string(dataLength) + " bytes");
+    }
+
+    std::vector<uint8_t> result(data + offset, data + offset + dataLength);
+    offset += (dataLength + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE;
+    return result;
 }
 
-std::string TypeDecoder::decodeString(const std::string& hexData, size_t& offset) {
-    // First read the length
-    std::string lengthHex = readBytes32(hexData, offset);
-    size_t stringLength = std::stoull(lengthHex, nullptr, 16);
-    
-    // Then read the actual string data
-    std::string result;
-    size_t hexChars = stringLength * 2;
-    size_t chunks = (hexChars + 63) / 64; // Round up to nearest 32-byte chunk
-    
-    for (size_t i = 0; i < chunks; i++) {
-        std::string chunk = readBytes32(hexData, offset);
-        size_t charsToRead = std::min(hexChars - i * 64, size_t(64));
-        auto bytes = Utils::hexToBytes(chunk.substr(0, charsToRead));
-        result.append(bytes.begin(), bytes.end());
+std::string TypeDecoder::decodeString(const uint8_t* data, size_t length, size_t& offset) {
+    // Strings share the dynamic bytes layout
+    size_t stringLength = readSize(data, length, offset);
+    if (stringLength > length - offset) {
+        throw std::runtime_error("Insufficient data to read " + std::to_string(stringLength) + " bytes");
     }
-    
+
+    std::string result(reinterpret_cast<const char*>(data + offset), stringLength);
+    offset += (stringLength + WORD_SIZE - 1) / WORD_SIZE * WORD_SIZE;
     return result;
 }
 
-std::vector<DecodedValue> TypeDecoder::decodeArray(const std::string& elementType, 
-                                                   const std::string& hexData, 
-                                                   size_t& offset, 
-                                                   size_t length) {
-    std::vector<DecodedValue> result;
-    
-    if (length == 0) {
-        // Dynamic array - read length first
-        std::string lengthHex = readBytes32(hexData, offset);
-        length = std::stoull(lengthHex, nullptr, 16);
+DecodedValue TypeDecoder::decodeTypeString(std::string_view type, const uint8_t* data, size_t length, size_t& offset) {
+    ABITypeInfo info;
+    if (!ABITypeParser::parse(type, info)) {
+        throw std::runtime_error("Unsupported type: " + std::string(type));
     }
-    
-    if (isDynamicType(elementType)) {
-        // Array of dynamic types - read offsets first
-        std::vector<size_t> elementOffsets;
-        size_t baseOffset = offset;
-        
-        for (size_t i = 0; i < length; i++) {
-            std::string offsetHex = readBytes32(hexData, offset);
-            elementOffsets.push_back(baseOffset + std::stoull(offsetHex, nullptr, 16) * 2);
+
+    switch (info.opcode) {
+        case ABIOpcode::Address:
+            return decodeAddress(data, length, offset);
+        case ABIOpcode::Uint:
+            return decodeUint256(data, length, offset);
+        case ABIOpcode::Int:
+            return decodeInt256(data, length, offset);
+        case ABIOpcode::Bool:
+            return decodeBool(data, length, offset);
+        case ABIOpcode::FixedBytes:
+            if (info.size == WORD_SIZE) {
+                return decodeBytes32(data, length, offset);
+            }
+            return decodeBytes(data, length, offset, info.size);
+        case ABIOpcode::Bytes:
+            return decodeBytes(data, length, offset, 0);
+        case ABIOpcode::String:
+            return decodeString(data, length, offset);
+        case ABIOpcode::DynamicArray:
+        case ABIOpcode::FixedArray: {
+            size_t arrayLength = info.opcode == ABIOpcode::DynamicArray ? readSize(data, length, offset) : info.arrayLength;
+            return decodeArray(info.inner, data, length, offset, arrayLength);
         }
-        
-        // Then decode each element at its offset
-        for (size_t elementOffset : elementOffsets) {
-            result.push_back(decodeValue(elementType, hexData, elementOffset));
+        case ABIOpcode::Tuple: {
+            // Components are laid out like a nested parameter list based at the tuple start
+            std::map<std::string, std::string> components;
+            size_t base = offset;
+            std::string_view component;
+            for (size_t i = 0; ABITypeParser::nextComponent(info.inner, component); i++) {
+                DecodedValue value;
+                if (ABITypeParser::isDynamic(component)) {
+                    size_t componentOffset = base + readSize(data, length, offset);
+                    value = decodeTypeString(component, data, length, componentOffset);
+                } else {
+                    value = decodeTypeString(component, data, length, offset);
+                }
+                components[std::to_string(i)] = formatValue(value);
+            }
+            return components;
+        }
+    }
+
+    throw std::runtime_error("Unsupported type: " + std::string(type));
+}
+
+std::vector<std::string> TypeDecoder::decodeArray(std::string_view elementType,
+                                                  const uint8_t* data,
+                                                  size_t length,
+                                                  size_t& offset,
+                                                  size_t arrayLength) {
+    // Every element occupies at least one word, which bounds a sane length
+    if (arrayLength > (length - std::min(offset, length)) / WORD_SIZE) {
+        throw std::runtime_error("Array length " + std::to_string(arrayLength) + " exceeds available data");
+    }
+
+    std::vector<std::string> result;
+    result.reserve(arrayLength);
+
+    if (ABITypeParser::isDynamic(elementType)) {
+        // Array of dynamic types - offsets are relative to the start of the element heads
+        size_t baseOffset = offset;
+
+        for (size_t i = 0; i < arrayLength; i++) {
+            size_t elementOffset = baseOffset + readSize(data, length, offset);
+            result.push_back(formatValue(decodeTypeString(elementType, data, length, elementOffset)));
         }
     } else {
         // Array of static types - decode sequentially
-        for (size_t i = 0; i < length; i++) {
-            result.push_back(decodeValue(elementType, hexData, offset));
+        for (size_t i = 0; i < arrayLength; i++) {
+            result.push_back(formatValue(decodeTypeString(elementType, data, length, offset)));
         }
     }
-    
+
     return result;
 }
 
-std::string TypeDecoder::readBytes32(const std::string& hexData, size_t& offset) {
-    if (offset + 64 > hexData.length()) {
+const uint8_t* TypeDecoder::readWord(const uint8_t* data, size_t length, size_t& offset) {
+    if (offset > length || length - offset < WORD_SIZE) {
         throw std::runtime_error("Insufficient data to read 32 bytes");
     }
-    
-    std::string bytes32 = hexData.substr(offset, 64);
-    offset += 64;
-    return bytes32;
-}
 
-uint64_t TypeDecoder::hexToUint64(const std::string& hex) {
-    return std::stoull(hex, nullptr, 16);
+    const uint8_t* word = data + offset;
+    offset += WORD_SIZE;
+    return word;
 }
 
-std::string TypeDecoder::removeHexPrefix(const std::string& hex) {
-    return Utils::removeHexPrefix(hex);
-}
+size_t TypeDecoder::readSize(const uint8_t* data, size_t length, size_t& offset) {
+    const uint8_t* word = readWord(data, length, offset);
 
-bool TypeDecoder::isDynamicType(const std::string& type) {
-    // Dynamic types: bytes, string, T[] (dynamic arrays), and dynamic tuples
-    if (type == "bytes" || type == "string") {
-        return true;
+    // Offsets and lengths must fit into the low 8 bytes of the word
+    if (std::any_of(word, word + WORD_SIZE - 8, [](uint8_t b) { return b != 0; })) {
+        throw std::runtime_error("ABI offset or length out of range");
     }
-    
-    // Check for dynamic array (ends with [])
-    if (type.length() >= 2 && type.substr(type.length() - 2) == "[]") {
-        return true;
-    }
-    
-    // Tuples containing dynamic types would also be dynamic, but we'll handle that separately
-    
-    return false;
-}
 
-std::pair<std::string, size_t> TypeDecoder::parseArrayType(const std::string& type) {
-    std::regex arrayRegex("^(.+)\\[([0-9]*)\\]$");
-    std::smatch match;
-    
-    if (std::regex_match(type, match, arrayRegex)) {
-        std::string elementType = match[1].str();
-        std::string lengthStr = match[2].str();
-        size_t length = lengthStr.empty() ? 0 : std::stoul(lengthStr);
-        return {elementType, length};
+    uint64_t value = 0;
+    for (size_t i = WORD_SIZE - 8; i < WORD_SIZE; i++) {
+        value = (value << 8) | word[i];
     }
-    
-    return {"", 0};
+    return static_cast<size_t>(value);
 }
 
-} // namespace ethereum_decoder
\ No newline at end of file
+} // namespace ethereum_decoder
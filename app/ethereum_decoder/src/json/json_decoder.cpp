@@ -1,4 +1,5 @@
 #include "../include/json/json_decoder.h"
+#include "../include/utils.h"
 #include <sstream>
 #include <iomanip>
 
@@ -23,6 +24,10 @@ nlohmann::json JsonDecoder::decodedValueToJson(const DecodedValue& value) {
                     ss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
                 }
                 return ss.str();
+            } else if constexpr (std::is_same_v<T, UInt256> || std::is_same_v<T, Int256>) {
+                return val.toDecimal();
+            } else if constexpr (std::is_same_v<T, AddressBytes> || std::is_same_v<T, Bytes32>) {
+                return "0x" + Utils::bytesToHex(val.data(), val.size());
             } else if constexpr (std::is_same_v<T, std::vector<std::string>>) {
                 return nlohmann::json(val);
             } else if constexpr (std::is_same_v<T, std::map<std::string, std::string>>) {
@@ -0,0 +1,116 @@
+#include "../include/uint256.h"
+#include <stdexcept>
+
+namespace ethereum_decoder {
+
+namespace {
+
+// Largest power of ten that fits in 64 bits, so each division step yields 19 digits
+constexpr uint64_t DECIMAL_CHUNK = 10000000000000000000ULL;
+constexpr size_t DECIMAL_CHUNK_DIGITS = 19;
+
+// 2^256 has 78 decimal digits, plus room for a sign
+constexpr size_t MAX_DECIMAL_LENGTH = 80;
+
+} // anonymous namespace
+
+UInt256 UInt256::fromBigEndian(const uint8_t* bytes, size_t length) {
+    UInt256 value;
+    if (length > BYTES) {
+        bytes += length - BYTES;
+        length = BYTES;
+    }
+
+    // Walk from the least significant byte upwards
+    for (size_t i = 0; i < length; i++) {
+        value.limbs_[i / 8] |= static_cast<uint64_t>(bytes[length - 1 - i]) << ((i % 8) * 8);
+    }
+    return value;
+}
+
+UInt256 UInt256::fromDecimal(std::string_view digits) {
+    if (digits.empty()) {
+        throw std::runtime_error("Empty decimal number");
+    }
+
+    UInt256 value;
+    for (char c : digits) {
+        if (c < '0' || c > '9') {
+            throw std::runtime_error("Invalid decimal number: " + std::string(digits));
+        }
+
+        // value = value * 10 + digit, carried through the limbs
+        unsigned __int128 carry = static_cast<unsigned>(c - '0');
+        for (size_t i = 0; i < 4; i++) {
+            unsigned __int128 current = static_cast<unsigned __int128>(value.limbs_[i]) * 10 + carry;
+            value.limbs_[i] = static_cast<uint64_t>(current);
+            carry = current >> 64;
+        }
+        if (carry != 0) {
+            throw std::runtime_error("Decimal number exceeds 256 bits: " + std::string(digits));
+        }
+    }
+    return value;
+}
+
+void UInt256::toBigEndian(uint8_t* bytes) const {
+    for (size_t i = 0; i < BYTES; i++) {
+        bytes[BYTES - 1 - i] = static_cast<uint8_t>(limbs_[i / 8] >> ((i % 8) * 8));
+    }
+}
+
+UInt256 UInt256::negate() const {
+    UInt256 result;
+    uint64_t carry = 1;
+    for (size_t i = 0; i < 4; i++) {
+        uint64_t inverted = ~limbs_[i];
+        result.limbs_[i] = inverted + carry;
+        carry = (carry && result.limbs_[i] == 0) ? 1 : 0;
+    }
+    return result;
+}
+
+uint64_t UInt256::divideBy(uint64_t divisor) {
+    unsigned __int128 remainder = 0;
+    for (size_t i = 4; i-- > 0;) {
+        unsigned __int128 current = (remainder << 64) | limbs_[i];
+        limbs_[i] = static_cast<uint64_t>(current / divisor);
+        remainder = current % divisor;
+    }
+    return static_cast<uint64_t>(remainder);
+}
+
+std::string UInt256::toDecimal() const {
+    return formatDecimal(*this, false);
+}
+
+std::string UInt256::toSignedDecimal() const {
+    return isNegative() ? formatDecimal(negate(), true) : formatDecimal(*this, false);
+}
+
+std::string UInt256::formatDecimal(UInt256 value, bool negative) {
+    if (value.isZero()) {
+        return "0";
+    }
+
+    // Fill digits from the end of a stack buffer, one 19-digit chunk per division
+    char buffer[MAX_DECIMAL_LENGTH];
+    char* end = buffer + sizeof(buffer);
+    char* pos = end;
+
+    while (!value.isZero()) {
+        uint64_t chunk = value.divideBy(DECIMAL_CHUNK);
+        bool last = value.isZero();
+        for (size_t digit = 0; digit < DECIMAL_CHUNK_DIGITS && (!last || chunk != 0); digit++) {
+            *--pos = static_cast<char>('0' + chunk % 10);
+            chunk /= 10;
+        }
+    }
+
+    if (negative) {
+        *--pos = '-';
+    }
+    return std::string(pos, end);
+}
+
+} // namespace ethereum_decoder
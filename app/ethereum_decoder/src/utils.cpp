@@ -1,39 +1,85 @@
 #include "../include/utils.h"
+#include "../include/uint256.h"
 #include <algorithm>
 #include <sstream>
 #include <iomanip>
 #include <cctype>
+#include <stdexcept>
 
 namespace ethereum_decoder {
 
-std::vector<uint8_t> Utils::hexToBytes(const std::string& hex) {
-    std::string cleanHex = removeHexPrefix(hex);
-    
-    if (cleanHex.length() % 2 != 0) {
-        cleanHex = "0" + cleanHex;
+namespace {
+
+// Value of a single hex digit, or -1 if the character is not a hex digit
+int hexNibble(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Length of the 0x prefix, if present
+size_t hexPrefixLength(const std::string& hex) {
+    return (hex.size() >= 2 && hex[0] == '0' && (hex[1] == 'x' || hex[1] == 'X')) ? 2 : 0;
+}
+
+// Decode digits [begin, end) into out; an odd digit count is left-padded with a zero nibble
+void decodeHexDigits(const char* begin, const char* end, uint8_t* out) {
+    if ((end - begin) % 2 != 0) {
+        int low = hexNibble(*begin++);
+        if (low < 0) {
+            throw std::runtime_error("Invalid hex character");
+        }
+        *out++ = static_cast<uint8_t>(low);
     }
-    
-    std::vector<uint8_t> bytes;
-    bytes.reserve(cleanHex.length() / 2);
-    
-    for (size_t i = 0; i < cleanHex.length(); i += 2) {
-        std::string byteString = cleanHex.substr(i, 2);
-        uint8_t byte = static_cast<uint8_t>(std::stoul(byteString, nullptr, 16));
-        bytes.push_back(byte);
+
+    for (; begin != end; begin += 2) {
+        int high = hexNibble(begin[0]);
+        int low = hexNibble(begin[1]);
+        if (high < 0 || low < 0) {
+            throw std::runtime_error("Invalid hex character");
+        }
+        *out++ = static_cast<uint8_t>((high << 4) | low);
     }
+}
+
+} // namespace
+
+std::vector<uint8_t> Utils::hexToBytes(const std::string& hex) {
+    const char* begin = hex.data() + hexPrefixLength(hex);
+    const char* end = hex.data() + hex.size();
+
+    std::vector<uint8_t> bytes((end - begin + 1) / 2);
+    decodeHexDigits(begin, end, bytes.data());
     
     return bytes;
 }
 
+void Utils::hexToBytes(const std::string& hex, uint8_t* out, size_t outLength) {
+    const char* begin = hex.data() + hexPrefixLength(hex);
+    const char* end = hex.data() + hex.size();
+
+    if (static_cast<size_t>(end - begin) != outLength * 2) {
+        throw std::runtime_error("Expected " + std::to_string(outLength) + " bytes of hex data");
+    }
+
+    decodeHexDigits(begin, end, out);
+}
+
 std::string Utils::bytesToHex(const std::vector<uint8_t>& bytes) {
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
-    
-    for (uint8_t byte : bytes) {
-        ss << std::setw(2) << static_cast<int>(byte);
+    return bytesToHex(bytes.data(), bytes.size());
+}
+
+std::string Utils::bytesToHex(const uint8_t* bytes, size_t length) {
+    static const char digits[] = "0123456789abcdef";
+
+    std::string hex(length * 2, '0');
+    for (size_t i = 0; i < length; i++) {
+        hex[2 * i] = digits[bytes[i] >> 4];
+        hex[2 * i + 1] = digits[bytes[i] & 0x0f];
     }
     
-    return ss.str();
+    return hex;
 }
 
 std::string Utils::removeHexPrefix(const std::string& hex) {
@@ -73,57 +119,71 @@ std::string Utils::padRight(const std::string& hex, size_t length) {
 }
 
 std::string Utils::hexToDecimal(const std::string& hex) {
-    std::string cleanHex = removeHexPrefix(hex);
-    
-    // Remove leading zeros
-    size_t firstNonZero = cleanHex.find_first_not_of('0');
-    if (firstNonZero == std::string::npos) {
+    const char* begin = hex.data() + hexPrefixLength(hex);
+    const char* end = hex.data() + hex.size();
+    while (begin != end && *begin == '0') {
+        begin++;
+    }
+
+    // Values up to 256 bits are decoded on the stack
+    size_t byteLength = (end - begin + 1) / 2;
+    if (byteLength <= UInt256::BYTES) {
+        uint8_t word[UInt256::BYTES];
+        decodeHexDigits(begin, end, word);
+        return UInt256::fromBigEndian(word, byteLength).toDecimal();
+    }
+
+    std::vector<uint8_t> bytes(byteLength);
+    decodeHexDigits(begin, end, bytes.data());
+    return bytesToDecimal(bytes.data(), bytes.size());
+}
+
+std::string Utils::bytesToDecimal(const uint8_t* bytes, size_t length) {
+    // Skip leading zero bytes
+    while (length > 0 && *bytes == 0) {
+        bytes++;
+        length--;
+    }
+    if (length == 0) {
         return "0";
     }
-    cleanHex = cleanHex.substr(firstNonZero);
-    
-    // Convert to decimal string using basic arithmetic
-    std::string result = "0";
-    
-    for (char c : cleanHex) {
-        // Multiply current result by 16
-        std::string temp = "";
-        int carry = 0;
-        
-        for (int i = result.length() - 1; i >= 0; i--) {
-            int digit = (result[i] - '0') * 16 + carry;
-            temp = std::to_string(digit % 10) + temp;
-            carry = digit / 10;
-        }
-        
-        if (carry > 0) {
-            temp = std::to_string(carry) + temp;
-        }
-        
-        result = temp;
-        
-        // Add hex digit value
-        int hexValue = (c >= '0' && c <= '9') ? (c - '0') : 
-                       (c >= 'a' && c <= 'f') ? (c - 'a' + 10) :
-                       (c >= 'A' && c <= 'F') ? (c - 'A' + 10) : 0;
-        
-        carry = hexValue;
-        temp = "";
-        
-        for (int i = result.length() - 1; i >= 0; i--) {
-            int digit = (result[i] - '0') + carry;
-            temp = std::to_string(digit % 10) + temp;
-            carry = digit / 10;
+
+    // Anything up to 256 bits goes through the fixed-width limb path
+    if (length <= UInt256::BYTES) {
+        return UInt256::fromBigEndian(bytes, length).toDecimal();
+    }
+
+    // Repeated division by 10 over a big-endian scratch copy
+    uint8_t scratch[64];
+    std::vector<uint8_t> heapScratch;
+    uint8_t* number = scratch;
+    if (length > sizeof(scratch)) {
+        heapScratch.resize(length);
+        number = heapScratch.data();
+    }
+    std::copy(bytes, bytes + length, number);
+
+    // log10(256) < 2.41, so every byte contributes at most 3 digits
+    std::string digits;
+    digits.reserve(length * 3);
+
+    size_t start = 0;
+    while (start < length) {
+        uint32_t remainder = 0;
+        for (size_t i = start; i < length; i++) {
+            uint32_t current = (remainder << 8) | number[i];
+            number[i] = static_cast<uint8_t>(current / 10);
+            remainder = current % 10;
         }
-        
-        if (carry > 0) {
-            temp = std::to_string(carry) + temp;
+        digits.push_back(static_cast<char>('0' + remainder));
+
+        while (start < length && number[start] == 0) {
+            start++;
         }
-        
-        result = temp;
     }
-    
-    return result;
+
+    std::reverse(digits.begin(), digits.end());
+    return digits;
 }
 
 bool Utils::isValidHex(const std::string& hex) {
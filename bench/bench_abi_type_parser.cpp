@@ -0,0 +1,143 @@
+// Micro-benchmark: ABITypeParser against the std::regex type parsing it replaced in TypeDecoder.
+// Usage: bench_abi_type_parser [iterations]
+
+#include "decoding/abi_type_parser.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <regex>
+#include <string>
+#include <vector>
+
+using ethereum_decoder::ABIOpcode;
+using ethereum_decoder::ABITypeInfo;
+using ethereum_decoder::ABITypeParser;
+
+namespace {
+
+// Type strings as they appear in common event ABIs
+const std::vector<std::string> TYPES = {
+    "address", "uint256", "bool", "bytes32", "bytes", "string", "uint256[]", "address[3]",
+};
+
+// Outermost layer of a type with the regexes TypeDecoder used: "^(.+)\[([0-9]*)\]$" for arrays
+// and "^bytes([0-9]+)$" for fixed bytes
+bool regexParse(const std::string& type, const std::regex& arrayRegex, const std::regex& fixedBytesRegex,
+                ABITypeInfo& info) {
+    info = ABITypeInfo();
+    std::smatch match;
+
+    if (std::regex_match(type, match, arrayRegex)) {
+        std::string lengthStr = match[2].str();
+        info.opcode = lengthStr.empty() ? ABIOpcode::DynamicArray : ABIOpcode::FixedArray;
+        info.arrayLength = lengthStr.empty() ? 0 : std::stoul(lengthStr);
+        info.inner = std::string_view(type).substr(0, match.length(1));
+        return true;
+    }
+    if (type == "address") {
+        info.opcode = ABIOpcode::Address;
+        info.size = 20;
+        return true;
+    }
+    if (type == "bool") {
+        info.opcode = ABIOpcode::Bool;
+        return true;
+    }
+    if (type.compare(0, 4, "uint") == 0) {
+        info.opcode = ABIOpcode::Uint;
+        info.size = type.size() == 4 ? 256 : std::stoul(type.substr(4));
+        return true;
+    }
+    if (type.compare(0, 3, "int") == 0) {
+        info.opcode = ABIOpcode::Int;
+        info.size = type.size() == 3 ? 256 : std::stoul(type.substr(3));
+        return true;
+    }
+    if (std::regex_match(type, match, fixedBytesRegex)) {
+        info.opcode = ABIOpcode::FixedBytes;
+        info.size = std::stoul(match[1].str());
+        return true;
+    }
+    if (type == "bytes") {
+        info.opcode = ABIOpcode::Bytes;
+        return true;
+    }
+    if (type == "string") {
+        info.opcode = ABIOpcode::String;
+        return true;
+    }
+    return false;
+}
+
+// TypeDecoder compiled both regexes on every call
+bool regexParseCompiled(const std::string& type, ABITypeInfo& info) {
+    std::regex arrayRegex("^(.+)\\[([0-9]*)\\]$");
+    std::regex fixedBytesRegex("^bytes([0-9]+)$");
+    return regexParse(type, arrayRegex, fixedBytesRegex, info);
+}
+
+// Regexes compiled once, to separate compilation from matching
+bool regexParseCached(const std::string& type, ABITypeInfo& info) {
+    static const std::regex arrayRegex("^(.+)\\[([0-9]*)\\]$");
+    static const std::regex fixedBytesRegex("^bytes([0-9]+)$");
+    return regexParse(type, arrayRegex, fixedBytesRegex, info);
+}
+
+bool parserParse(const std::string& type, ABITypeInfo& info) {
+    return ABITypeParser::parse(type, info);
+}
+
+// Nanoseconds per type string over all TYPES
+template <typename Parse>
+double measure(Parse parse, size_t iterations, size_t& sink) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        for (const auto& type : TYPES) {
+            ABITypeInfo info;
+            if (parse(type, info)) {
+                sink += info.size + info.arrayLength + info.inner.size();
+            }
+        }
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / static_cast<double>(iterations * TYPES.size());
+}
+
+bool sameInfo(const ABITypeInfo& a, const ABITypeInfo& b) {
+    return a.opcode == b.opcode && a.size == b.size && a.arrayLength == b.arrayLength && a.inner == b.inner;
+}
+
+} // anonymous namespace
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000;
+    if (iterations == 0) {
+        std::cerr << "Usage: " << argv[0] << " [iterations]" << std::endl;
+        return 1;
+    }
+
+    // Both paths must agree before their timings mean anything
+    for (const auto& type : TYPES) {
+        ABITypeInfo expected;
+        ABITypeInfo actual;
+        if (!regexParseCached(type, expected) || !parserParse(type, actual) || !sameInfo(expected, actual)) {
+            std::cerr << "❌ Parsers disagree on " << type << std::endl;
+            return 1;
+        }
+    }
+
+    // Compiling regexes is slow enough that a fraction of the iterations gives a stable figure
+    size_t compiledIterations = std::max<size_t>(iterations / 1000, 1);
+    size_t sink = 0;
+    double compiled = measure(regexParseCompiled, compiledIterations, sink);
+    double cached = measure(regexParseCached, iterations / 10 + 1, sink);
+    double parser = measure(parserParse, iterations, sink);
+
+    std::cout << "ABI type parsing, " << TYPES.size() << " type strings (ns per type):" << std::endl;
+    std::cout << "  std::regex compiled per call  " << compiled << std::endl;
+    std::cout << "  std::regex compiled once      " << cached << std::endl;
+    std::cout << "  ABITypeParser                 " << parser << std::endl;
+    std::cout << "  speedup over per-call regex   " << compiled / parser << "x" << std::endl;
+    return sink == 0 ? 1 : 0;
+}
@@ -0,0 +1,16 @@
+#!/bin/bash
+# Compare ABITypeParser with the std::regex type parsing TypeDecoder used before it.
+# Usage: ./bench_abi_type_parser.sh [iterations]
+
+set -e
+
+CXX=${CXX:-g++}
+BIN=./bin/bench_abi_type_parser
+
+mkdir -p bin
+$CXX -std=c++17 -Wall -O2 -I./app/ethereum_decoder/include \
+    bench/bench_abi_type_parser.cpp \
+    app/ethereum_decoder/src/decoding/abi_type_parser.cpp \
+    -o "$BIN"
+
+"$BIN" "$@"
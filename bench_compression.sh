@@ -0,0 +1,99 @@
+#!/bin/bash
+# Compare decode_clickhouse fetch throughput per wire compression method
+# against a local ClickHouse server seeded with synthetic logs.
+# Usage: ./bench_compression.sh [rows]
+#
+# Starts a throwaway clickhouse/clickhouse-server container unless BENCH_HOST is set,
+# in which case that server is used (BENCH_PORT, BENCH_USER, BENCH_PASSWORD, BENCH_DATABASE).
+# Loopback has no bandwidth limit, so locally the numbers mostly show the CPU cost of
+# each method; point BENCH_HOST at a remote server to measure over a real link.
+
+set -e
+
+ROWS=${1:-2000000}
+BIN=${BIN:-./bin/decode_clickhouse}
+CONTAINER=ethereum-decoder-bench
+BENCH_PORT=${BENCH_PORT:-9000}
+BENCH_USER=${BENCH_USER:-bench}
+BENCH_PASSWORD=${BENCH_PASSWORD:-bench}
+BENCH_DATABASE=${BENCH_DATABASE:-bench}
+OUT_DIR=$(mktemp -d)
+
+if [[ ! -x "$BIN" ]]; then
+    echo "❌ $BIN not found, build it with ./make_decode_clickhouse.sh"
+    exit 1
+fi
+
+LOCAL_SERVER=0
+
+cleanup() {
+    rm -rf "$OUT_DIR"
+    if [[ "$LOCAL_SERVER" == "1" ]]; then
+        docker rm -f "$CONTAINER" > /dev/null 2>&1 || true
+    fi
+}
+trap cleanup EXIT
+
+if [[ -z "$BENCH_HOST" ]]; then
+    BENCH_HOST=127.0.0.1
+    LOCAL_SERVER=1
+    echo "Starting local ClickHouse..."
+    docker run -d --name "$CONTAINER" -p "$BENCH_PORT:9000" \
+        -e CLICKHOUSE_USER="$BENCH_USER" -e CLICKHOUSE_PASSWORD="$BENCH_PASSWORD" \
+        -e CLICKHOUSE_DB="$BENCH_DATABASE" clickhouse/clickhouse-server > /dev/null
+    until docker exec "$CONTAINER" clickhouse-client --user "$BENCH_USER" --password "$BENCH_PASSWORD" \
+            --query "SELECT 1" > /dev/null 2>&1; do
+        sleep 1
+    done
+fi
+
+ch() {
+    if [[ "$LOCAL_SERVER" == "1" ]]; then
+        docker exec -i "$CONTAINER" clickhouse-client --user "$BENCH_USER" --password "$BENCH_PASSWORD" \
+            --database "$BENCH_DATABASE" --multiquery
+    else
+        clickhouse-client --host "$BENCH_HOST" --port "$BENCH_PORT" --user "$BENCH_USER" \
+            --password "$BENCH_PASSWORD" --database "$BENCH_DATABASE" --multiquery
+    fi
+}
+
+# Hex columns like the real logs table; ~10 logs per block
+echo "Seeding $ROWS logs..."
+ch <<SQL
+DROP TABLE IF EXISTS logs;
+DROP TABLE IF EXISTS decoded_contracts;
+CREATE TABLE logs (
+    transactionHash String, blockNumber UInt64, address String, data String, logIndex UInt32,
+    topic0 Nullable(String), topic1 Nullable(String), topic2 Nullable(String), topic3 Nullable(String),
+    removed UInt8
+) ENGINE = MergeTree ORDER BY (blockNumber, logIndex);
+CREATE TABLE decoded_contracts (
+    ADDRESS String, NAME String, ABI String, IMPLEMENTATION_ADDRESS String
+) ENGINE = MergeTree ORDER BY ADDRESS;
+INSERT INTO logs SELECT
+    concat('0x', lower(hex(SHA256(toString(intDiv(number, 3)))))),
+    intDiv(number, 10),
+    concat('0x', substring(lower(hex(SHA256(toString(number % 500)))), 1, 40)),
+    concat('0x', lower(hex(SHA256(toString(number)))), repeat('0', 48), lower(hex(toUInt64(number)))),
+    number % 10,
+    '0xddf252ad1be2c89b69c2b068fc378daa952ba7f163c4a11628f55a4df523b3ef',
+    concat('0x', repeat('0', 24), substring(lower(hex(SHA256(toString(number * 7)))), 1, 40)),
+    concat('0x', repeat('0', 24), substring(lower(hex(SHA256(toString(number * 13)))), 1, 40)),
+    NULL,
+    0
+FROM numbers($ROWS);
+SQL
+
+END_BLOCK=$(( ROWS / 10 - 1 ))
+echo ""
+printf "%-8s %10s %14s\n" "method" "seconds" "logs/second"
+for method in none lz4 zstd; do
+    rm -rf "$OUT_DIR/out"
+    start=$(date +%s.%N)
+    "$BIN" --host "$BENCH_HOST" --port "$BENCH_PORT" --user "$BENCH_USER" --password "$BENCH_PASSWORD" \
+        --database "$BENCH_DATABASE" --blockrange "0-$END_BLOCK" --compression "$method" \
+        --output-dir "$OUT_DIR/out" --json --log-file "$OUT_DIR/$method.log" --log-level warning > /dev/null
+    end=$(date +%s.%N)
+    awk -v m="$method" -v s="$start" -v e="$end" -v n="$ROWS" \
+        'BEGIN { printf "%-8s %10.2f %14.0f\n", m, e - s, n / (e - s) }'
+done
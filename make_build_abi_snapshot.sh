@@ -0,0 +1,65 @@
+#!/bin/bash
+# Build script for build_abi_snapshot
+# Usage: ./make_build_abi_snapshot.sh
+
+set -e
+
+CXX=${CXX:-g++}
+
+# Detect OpenSSL path (macOS Homebrew vs system)
+OPENSSL_PREFIX=${OPENSSL_PREFIX:-$(brew --prefix openssl 2>/dev/null || echo /usr/local)}
+
+# Manual dependency paths
+DEPS_DIR="deps"
+SPDLOG_DIR="$DEPS_DIR/spdlog"
+NLOHMANN_JSON_DIR="$DEPS_DIR/nlohmann-json"
+CLICKHOUSE_CPP_DIR="$DEPS_DIR/clickhouse-cpp"
+ABSEIL_DIR="$DEPS_DIR/abseil-cpp"
+
+# Parquet support (optional) - set ENABLE_PARQUET=1 to enable
+if [[ "$ENABLE_PARQUET" == "1" ]]; then
+    # Use external PARQUET_CFLAGS/PARQUET_LDFLAGS if provided, otherwise use local build
+    if [[ -z "$PARQUET_CFLAGS" ]]; then
+        ARROW_DIR="$DEPS_DIR/arrow"
+        PARQUET_CFLAGS="-DENABLE_PARQUET -I$ARROW_DIR/cpp/src -I$ARROW_DIR/cpp/build/src"
+    fi
+    if [[ -z "$PARQUET_LDFLAGS" ]]; then
+        PARQUET_LDFLAGS="-L$ARROW_DIR/cpp/build/release -larrow"
+    fi
+else
+    PARQUET_CFLAGS=""
+    PARQUET_LDFLAGS=""
+fi
+
+CXXFLAGS="-std=c++17 -Wall -O2 -I./app/ethereum_decoder/include \
+          -I$SPDLOG_DIR/include \
+          -I$NLOHMANN_JSON_DIR/include \
+          -I$CLICKHOUSE_CPP_DIR \
+          -I$ABSEIL_DIR \
+          $PARQUET_CFLAGS \
+          -I$OPENSSL_PREFIX/include \
+          -I./app/build_abi_snapshot"
+
+# Create bin directory
+mkdir -p bin
+
+# Build ethereum_decoder library if it doesn't exist
+if [[ ! -f "lib/libethereum_decoder.a" ]]; then
+    echo "ethereum_decoder library not found, building it first..."
+    ./make_ethereum_decoder_lib.sh
+fi
+
+# Build build_abi_snapshot
+echo "Compiling build_abi_snapshot..."
+$CXX $CXXFLAGS \
+    app/build_abi_snapshot/main.cpp \
+    app/build_abi_snapshot/src/build_abi_snapshot_arg_parser.cpp \
+    -Llib -lethereum_decoder \
+    -o bin/build_abi_snapshot
+
+echo "✓ build_abi_snapshot built successfully!"
+echo "  Output: bin/build_abi_snapshot"
+echo ""
+echo "Usage examples:"
+echo "  ./bin/build_abi_snapshot --abi-dir abis/ --output abis.snapshot"
+echo "  ./bin/build_abi_snapshot --export contracts.jsonl --base abis.snapshot --output abis.snapshot"
\ No newline at end of file
@@ -69,6 +69,7 @@ CXXFLAGS="-std=c++17 -Wall -O2 -I./app/ethereum_decoder/include \
           -I$SPDLOG_DIR/include \
           -I$NLOHMANN_JSON_DIR/include \
           -I$CLICKHOUSE_CPP_DIR \
+          -I$CLICKHOUSE_CPP_DIR/contrib/zstd/zstd \
           -I$ABSEIL_DIR \
           $PARQUET_CFLAGS \
           -I$OPENSSL_PREFIX/include \
@@ -81,6 +82,7 @@ LDFLAGS="-L$SPDLOG_DIR/build -lspdlog \
          -L$CLICKHOUSE_BUILD_DIR/clickhouse -lclickhouse-cpp-lib \
          -L$CLICKHOUSE_BUILD_DIR/contrib/lz4/lz4 -llz4 \
          -L$CLICKHOUSE_BUILD_DIR/contrib/zstd/zstd -lzstdstatic \
+         -lz \
          -L$CLICKHOUSE_BUILD_DIR/contrib/cityhash/cityhash -lcityhash \
          -L$CLICKHOUSE_BUILD_DIR/contrib/absl/absl -labsl_int128 \
          $PARQUET_LDFLAGS \
@@ -103,8 +105,18 @@ DECODE_CLICKHOUSE_SOURCES=(
     "app/decode_clickhouse/src/clickhouse/clickhouse_client.cpp"
     "app/decode_clickhouse/src/clickhouse/clickhouse_ethereum.cpp"
     "app/decode_clickhouse/src/clickhouse/clickhouse_query_config.cpp"
+    "app/decode_clickhouse/src/clickhouse/contract_abi_cache.cpp"
+    "app/decode_clickhouse/src/clickhouse/log_page.cpp"
+    "app/decode_clickhouse/src/pipeline/block_coverage.cpp"
+    "app/decode_clickhouse/src/pipeline/checkpoint.cpp"
+    "app/decode_clickhouse/src/pipeline/decode_pipeline.cpp"
+    "app/decode_clickhouse/src/pipeline/work_stealing_pool.cpp"
     "app/decode_clickhouse/src/parquet/parquet_database_writer.cpp"
+    "app/decode_clickhouse/src/parquet/parquet_dataset.cpp"
+    "app/decode_clickhouse/src/parquet/event_schema.cpp"
+    "app/decode_clickhouse/src/ndjson/ndjson_database_writer.cpp"
     "app/decode_clickhouse/src/log-writer/database_writer.cpp"
+    "app/decode_clickhouse/src/log-writer/file_sync.cpp"
     "app/decode_clickhouse/src/log-writer/clickhouse_writer.cpp"
     "app/decode_clickhouse/src/progress_display.cpp"
 )
@@ -44,7 +44,13 @@ SOURCES=(
     "app/ethereum_decoder/src/decoding/abi_parser.cpp"
     "app/ethereum_decoder/main.cpp"
     "app/ethereum_decoder/src/decoding/type_decoder.cpp"
+    "app/ethereum_decoder/src/decoding/decode_plan.cpp"
+    "app/ethereum_decoder/src/decoding/abi_type_parser.cpp"
+    "app/ethereum_decoder/src/decoding/event_lookup_table.cpp"
+    "app/ethereum_decoder/src/decoding/signature_registry.cpp"
+    "app/ethereum_decoder/src/decoding/abi_snapshot.cpp"
     "app/ethereum_decoder/src/utils.cpp"
+    "app/ethereum_decoder/src/uint256.cpp"
     "app/ethereum_decoder/src/crypto/keccak256_simple.cpp"
     "app/ethereum_decoder/src/json/json_decoder.cpp"
     "app/ethereum_decoder/src/decoding/log_data.cpp"
@@ -4,9 +4,11 @@
 -- This template allows customization of:
 -- - Target table name (change 'decoded_logs' to your table)
 -- - Column names and order
--- - Additional columns or transformations
 --
--- The placeholders will be replaced with escaped values from each log
+-- The statement is not executed as text: it maps each column to a {field}
+-- placeholder, and every batch is sent as one native block with these columns.
+-- Values must be plain placeholders. logIndex is sent as UInt32, blockNumber
+-- as UInt64 and all other fields as String
 INSERT INTO decoded_logs
 (
     transactionHash,
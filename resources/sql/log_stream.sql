@@ -1,9 +1,11 @@
--- Query for streaming logs with pagination
--- Parameters: {START_BLOCK}, {END_BLOCK}, {PAGE_SIZE}, {OFFSET}
+-- Query for streaming logs with keyset pagination on (blockNumber, logIndex)
+-- Parameters: {START_BLOCK}, {END_BLOCK}, {PAGE_SIZE}, {CURSOR_BLOCK}, {CURSOR_LOG_INDEX}
+-- Each page starts at the cursor (inclusive); the first page uses ({START_BLOCK}, 0)
 SELECT transactionHash, blockNumber, address, data, logIndex,
        topic0, topic1, topic2, topic3
 FROM logs
-WHERE blockNumber >= {START_BLOCK} AND blockNumber <= {END_BLOCK}
+WHERE blockNumber >= {CURSOR_BLOCK} AND blockNumber <= {END_BLOCK}
+  AND (blockNumber > {CURSOR_BLOCK} OR logIndex >= {CURSOR_LOG_INDEX})
   AND removed = 0
 ORDER BY blockNumber, logIndex
-LIMIT {PAGE_SIZE} OFFSET {OFFSET}
\ No newline at end of file
+LIMIT {PAGE_SIZE}
\ No newline at end of file
@@ -0,0 +1,17 @@
+-- Binary variant of log_stream.sql, used with --binary-logs
+-- Parameters: {START_BLOCK}, {END_BLOCK}, {PAGE_SIZE}, {CURSOR_BLOCK}, {CURSOR_LOG_INDEX}
+-- data is returned as raw bytes and topics as FixedString(32) instead of 0x-prefixed hex,
+-- halving what crosses the wire and sparing the decoder all hex parsing.
+-- Columns are read by position and must keep this order
+SELECT transactionHash, blockNumber, address,
+       unhex(substring(data, 3)) AS raw_data, logIndex,
+       toFixedString(unhex(substring(nullIf(topic0, ''), 3)), 32) AS raw_topic0,
+       toFixedString(unhex(substring(nullIf(topic1, ''), 3)), 32) AS raw_topic1,
+       toFixedString(unhex(substring(nullIf(topic2, ''), 3)), 32) AS raw_topic2,
+       toFixedString(unhex(substring(nullIf(topic3, ''), 3)), 32) AS raw_topic3
+FROM logs
+WHERE blockNumber >= {CURSOR_BLOCK} AND blockNumber <= {END_BLOCK}
+  AND (blockNumber > {CURSOR_BLOCK} OR logIndex >= {CURSOR_LOG_INDEX})
+  AND removed = 0
+ORDER BY blockNumber, logIndex
+LIMIT {PAGE_SIZE}
\ No newline at end of file
@@ -0,0 +1,226 @@
+// Stress test for the pipeline's concurrency primitives: WorkStealingPool and MpscQueue.
+// Fails if a task or item is lost, duplicated or left hanging after wait() or close()
+
+#include "include/pipeline/mpsc_queue.h"
+#include "include/pipeline/work_stealing_pool.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using decode_clickhouse::MpscQueue;
+using decode_clickhouse::WorkStealingPool;
+
+namespace {
+
+int failures = 0;
+
+void check(bool condition, const std::string& message) {
+    if (!condition) {
+        std::cerr << "✗ " << message << std::endl;
+        failures++;
+    }
+}
+
+// Every counter must have been bumped exactly once
+bool allOnce(const std::vector<std::atomic<int>>& counters) {
+    for (const auto& counter : counters) {
+        if (counter.load() != 1) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testPoolRuns(size_t workers) {
+    const size_t rounds = 200;
+    const size_t tasksPerRound = 500;
+    WorkStealingPool pool(workers);
+
+    for (size_t round = 0; round < rounds; ++round) {
+        std::vector<std::atomic<int>> runs(tasksPerRound);
+
+        // Half one by one, half as a batch
+        for (size_t i = 0; i < tasksPerRound / 2; ++i) {
+            pool.submit([&runs, i] { runs[i]++; });
+        }
+        std::vector<WorkStealingPool::Task> batch;
+        for (size_t i = tasksPerRound / 2; i < tasksPerRound; ++i) {
+            batch.push_back([&runs, i] { runs[i]++; });
+        }
+        pool.submitAll(std::move(batch));
+
+        pool.wait();
+        check(allOnce(runs), "pool with " + std::to_string(workers) + " workers, round " + std::to_string(round) +
+                             ": a task was lost or ran twice before wait() returned");
+    }
+}
+
+void testPoolNestedSubmit(size_t workers) {
+    const size_t parents = 2000;
+    const size_t children = 8;
+    WorkStealingPool pool(workers);
+    std::vector<std::atomic<int>> runs(parents * children);
+
+    for (size_t parent = 0; parent < parents; ++parent) {
+        // Submitted from a worker, so they go to that worker's own deque
+        pool.submit([&pool, &runs, parent] {
+            for (size_t child = 0; child < children; ++child) {
+                size_t index = parent * children + child;
+                pool.submit([&runs, index] { runs[index]++; });
+            }
+        });
+    }
+
+    pool.wait();
+    check(allOnce(runs), "pool with " + std::to_string(workers) +
+                         " workers: a task submitted from a worker was lost or ran twice");
+}
+
+void testPoolDestructorDrains() {
+    const size_t tasks = 10000;
+    std::vector<std::atomic<int>> runs(tasks);
+    {
+        WorkStealingPool pool(4);
+        for (size_t i = 0; i < tasks; ++i) {
+            pool.submit([&runs, i] { runs[i]++; });
+        }
+    }
+    check(allOnce(runs), "pool destroyed without wait(): a queued task did not run exactly once");
+}
+
+void testPoolSurvivesThrowingTask() {
+    WorkStealingPool pool(2);
+    std::atomic<int> runs{0};
+    pool.submit([] { throw std::runtime_error("expected test failure"); });
+    pool.submit([&runs] { runs++; });
+    pool.wait();
+    check(runs.load() == 1, "pool: a task after a throwing one did not run");
+}
+
+void testQueueDelivery(size_t producers, size_t capacity) {
+    const size_t itemsPerProducer = 20000;
+    MpscQueue<std::pair<size_t, size_t>> queue(capacity);
+
+    std::vector<std::thread> threads;
+    for (size_t producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&queue, producer] {
+            for (size_t sequence = 0; sequence < itemsPerProducer; ++sequence) {
+                queue.push({producer, sequence});
+            }
+        });
+    }
+
+    std::vector<size_t> next(producers, 0);
+    size_t popped = 0;
+    bool ordered = true;
+    std::thread consumer([&] {
+        std::pair<size_t, size_t> item;
+        while (queue.pop(item)) {
+            // Items of one producer arrive in the order it pushed them, each exactly once
+            if (item.second != next[item.first]) {
+                ordered = false;
+            }
+            next[item.first] = item.second + 1;
+            popped++;
+        }
+    });
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    queue.close();
+    consumer.join();
+
+    std::string setup = std::to_string(producers) + " producers, capacity " + std::to_string(capacity);
+    check(ordered, "queue with " + setup + ": an item was duplicated, lost or reordered");
+    check(popped == producers * itemsPerProducer,
+          "queue with " + setup + ": popped " + std::to_string(popped) + " of " +
+          std::to_string(producers * itemsPerProducer) + " items");
+}
+
+void testQueueCloseWakesBlockedProducers() {
+    const size_t producers = 8;
+    MpscQueue<int> queue(2);
+    std::atomic<size_t> accepted{0};
+
+    // The queue stays full, so most producers block until close()
+    std::vector<std::thread> threads;
+    for (size_t producer = 0; producer < producers; ++producer) {
+        threads.emplace_back([&queue, &accepted] {
+            for (int i = 0; i < 100; ++i) {
+                if (!queue.push(i)) {
+                    return;
+                }
+                accepted++;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    queue.close();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    size_t popped = 0;
+    int item;
+    while (queue.pop(item)) {
+        popped++;
+    }
+    check(popped == accepted.load(), "queue closed with blocked producers: popped " + std::to_string(popped) +
+                                     " of " + std::to_string(accepted.load()) + " accepted items");
+    check(!queue.push(1), "queue: push after close() was accepted");
+}
+
+void testQueueCloseWakesConsumer() {
+    MpscQueue<int> queue(4);
+    std::atomic<bool> returned{false};
+    std::thread consumer([&] {
+        int item;
+        while (queue.pop(item)) {
+        }
+        returned = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.close();
+    consumer.join();
+    check(returned.load(), "queue: a waiting consumer did not return after close()");
+}
+
+} // anonymous namespace
+
+int main() {
+    // A lost wake-up shows up as a hang: fail instead of blocking the test run forever
+    std::thread([] {
+        std::this_thread::sleep_for(std::chrono::seconds(120));
+        std::cerr << "✗ timed out, a wait(), pop() or push() never returned" << std::endl;
+        std::_Exit(1);
+    }).detach();
+
+    for (size_t workers : {1, 2, 8}) {
+        testPoolRuns(workers);
+        testPoolNestedSubmit(workers);
+    }
+    testPoolDestructorDrains();
+    testPoolSurvivesThrowingTask();
+
+    for (size_t producers : {1, 4, 16}) {
+        testQueueDelivery(producers, 1);
+        testQueueDelivery(producers, 64);
+    }
+    testQueueCloseWakesBlockedProducers();
+    testQueueCloseWakesConsumer();
+
+    if (failures > 0) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "✓ work-stealing pool and MPSC queue passed" << std::endl;
+    return 0;
+}